@@ -57,9 +57,48 @@ int main(const int argc, const char * const * const argv) {
 		refs::OPT_CONSTRAINT = cmd.arg_bool(cmd_line::exp_mode_opts(),
 				"--constraint");
 		refs::OPT_PRINT_ALL = cmd.arg_bool(cmd_line::other_opts(), "--all");
+		refs::OPT_PRINT_STAT = cmd.arg_bool(cmd_line::other_opts(),
+				"--statistics");
 
 		const bool& is_self_loop = cmd.arg_bool(cmd_line::exp_mode_opts(),
 				"--self-loop");
+		refs::OPT_HUGE_PAGES = cmd.arg_bool(cmd_line::exp_mode_opts(),
+				"--huge-pages");
+		refs::OPT_COMPRESS = cmd.arg_bool(cmd_line::exp_mode_opts(),
+				"--compress-states");
+		refs::OPT_ANTICHAIN = cmd.arg_bool(cmd_line::exp_mode_opts(),
+				"--antichain");
+		refs::OPT_POR = cmd.arg_bool(cmd_line::exp_mode_opts(),
+				"--partial-order");
+		refs::OPT_SLEEP_SETS = cmd.arg_bool(cmd_line::exp_mode_opts(),
+				"--sleep-sets");
+		refs::OPT_BACKWARD = cmd.arg_bool(cmd_line::exp_mode_opts(),
+				"--backward");
+		refs::IS_BWS_TREE = refs::OPT_BACKWARD
+				&& cmd.arg_bool(cmd_line::exp_mode_opts(), "--counterexample");
+		refs::OPT_ENGINE = cmd.arg_value(cmd_line::exp_mode_opts(),
+				"--engine");
+		if (refs::OPT_ENGINE != "fws" && refs::OPT_ENGINE != "mdd"
+				&& refs::OPT_ENGINE != "km"
+				&& refs::OPT_ENGINE != "astar")
+			throw ural_rt_err("main: unknown engine " + refs::OPT_ENGINE);
+		const string& threads = cmd.arg_value(cmd_line::exp_mode_opts(),
+				"--threads");
+		if (threads.empty()
+				|| threads.find_first_not_of("0123456789") != string::npos
+				|| threads.size() > 4)
+			throw ural_rt_err("main: invalid number of threads " + threads);
+		refs::OPT_THREADS = std::stoul(threads);
+		if (refs::OPT_THREADS == 0)
+			refs::OPT_THREADS = std::max(std::thread::hardware_concurrency(),
+					1u);
+		const string& rounds = cmd.arg_value(cmd_line::exp_mode_opts(),
+				"--refinements");
+		if (rounds.empty()
+				|| rounds.find_first_not_of("0123456789") != string::npos
+				|| rounds.size() > 9)
+			throw ural_rt_err("main: invalid number of refinements " + rounds);
+		refs::OPT_REFINEMENTS = std::stoul(rounds);
 
 		if (cmd.arg_bool(cmd_line::other_opts(), "--cmd-line")
 				|| refs::OPT_PRINT_ALL) {
@@ -73,6 +112,15 @@ int main(const int argc, const char * const * const argv) {
 				"--target");
 
 		ura u;
+
+		const string& compiled = cmd.arg_value(cmd_line::prob_inst_opts(),
+				"--compile");
+		if (compiled != "X") {
+			u.compile_ttd(filename, compiled, is_self_loop);
+			cout << filename << " is compiled into " << compiled << endl;
+			return 0;
+		}
+
 		const bool& is_reachable = u.unbounded_reachability_analysis(filename,
 				initl_ts, final_ts, is_self_loop);
 		cout << "======================================================\n";
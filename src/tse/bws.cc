@@ -0,0 +1,299 @@
+/**
+ * @name bws.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "bws.hh"
+
+namespace sura {
+
+const backward_search::id backward_search::NONE =
+        std::numeric_limits<id>::max();
+
+/**
+ * @brief constructor: the edges of the TTD are grouped by the shared state
+ *        they enter, as the pre-image of an element <s|c> only involves the
+ *        edges entering s
+ */
+backward_search::backward_search() :
+        L(thread_state::L), width(thread_state::L + COUNTERS), entering(
+                thread_state::S), occurring(size_t(thread_state::S) * thread_state::L,
+                false), nodes(), evicted(), bases(
+                thread_state::S), n_iterations(0), n_pruned(0), n_unreachable(0), n_evicted(
+                0), max_basis(0), n_basis(0) {
+    for (size_t v = 0; v < refs::original_TTD.size(); ++v) {
+        const thread_state src((id_thread_state(v)));
+        const auto& succ = refs::original_TTD.successors(src);
+        for (auto ie = succ.begin(); ie != succ.end(); ++ie)
+            entering[ie->dst.get_share()].push_back(
+                    edge { src, ie->dst.get_local(), ie->is_spawn });
+    }
+}
+
+backward_search::~backward_search() {
+}
+
+/**
+ * @brief search backwards from the upward closure of final, with
+ *        refs::TARGET_THR_NUM threads in its local state
+ * @return bool
+ * 		true : if an initial state is in the closure, i.e., final is
+ * 		       coverable
+ * 		false: otherwise
+ */
+bool backward_search::is_coverable() {
+    const shared_state& s_0 = refs::INITL_TS.get_share();
+    const local_state& l_0 = refs::INITL_TS.get_local();
+    const shared_state& s_F = refs::FINAL_TS.get_share();
+    const local_state& l_F = refs::FINAL_TS.get_local();
+    /// a thread state outside the TTD has no transition
+    if (s_0 >= thread_state::S || l_0 >= L)
+        return refs::FINAL_TS == refs::INITL_TS;
+    if (s_F >= thread_state::S || l_F >= L)
+        return false;
+    this->close_forward();
+
+    vector<uint32_t> M(width, 0), P(width);
+    M[SHARE] = s_F, M[PARENT] = NONE, M[COUNTERS + l_F] =
+            refs::TARGET_THR_NUM;
+    vector<id> frontier, next;
+    id v_0 = NONE;
+    if (this->is_occurring(M.data())) {
+        frontier.push_back(this->insert(M.data()).first);
+        if (this->is_initial(M.data()))
+            v_0 = frontier[0];
+    } else {
+        ++n_unreachable;
+    }
+    while (v_0 == NONE && !frontier.empty()) {
+        ++n_iterations;
+        for (auto iv = frontier.begin(); iv != frontier.end() && v_0 == NONE;
+                ++iv) {
+            if (evicted[*iv])
+                continue;
+            /// a copy, as inserting may move the records
+            std::memcpy(M.data(), this->record(*iv), width * sizeof(uint32_t));
+            const auto& in = entering[M[SHARE]];
+            for (auto ie = in.begin(); ie != in.end(); ++ie) {
+                /// the least c with c >= src and c after the edge >= M
+                const local_state& l = ie->src.get_local();
+                P = M;
+                P[SHARE] = ie->src.get_share(), P[PARENT] = *iv;
+                if (P[COUNTERS + ie->dst] > 0)
+                    --P[COUNTERS + ie->dst];
+                if (!ie->is_spawn)
+                    ++P[COUNTERS + l];
+                else if (P[COUNTERS + l] == 0)
+                    P[COUNTERS + l] = 1;
+                if (!this->is_occurring(P.data())) {
+                    ++n_unreachable;
+                    continue;
+                }
+                const auto& ins = this->insert(P.data());
+                if (!ins.second)
+                    continue;
+                if (this->is_initial(P.data())) {
+                    v_0 = ins.first;
+                    break;
+                }
+                next.push_back(ins.first);
+            }
+        }
+        frontier.swap(next);
+        next.clear();
+    }
+
+    if (v_0 != NONE) {
+        /// the initial state with the least number of threads in v_0
+        std::memcpy(M.data(), this->record(v_0), width * sizeof(uint32_t));
+        M[COUNTERS + l_0] = std::max(M[COUNTERS + l_0], 1u);
+        cout << refs::FINAL_TS << endl;
+        cout << "initial configuration: ";
+        this->to_stream(cout, M.data()) << endl;
+        if (refs::IS_BWS_TREE)
+            this->print_path(v_0);
+    }
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL)
+        this->print_stat() << endl;
+    return v_0 != NONE;
+}
+
+ostream& backward_search::print_stat(ostream& out) const {
+    out << "bws: " << PPRINT::plural(n_iterations, "iteration") << ", "
+            << PPRINT::plural(evicted.size(), "element") << ", basis of "
+            << n_basis << " (final) " << max_basis << " (max), " << n_evicted
+            << " evicted, " << n_pruned << " pruned, " << n_unreachable
+            << " unreachable, "
+            << nodes.size() * sizeof(uint32_t) / 1024 << " KiB of elements";
+    return out;
+}
+
+/**
+ * @brief compute the thread states that can occur in a reachable state:
+ *        the initial one, the one an edge enters from a thread state that
+ *        can occur, and <s'|l> if a thread can be in l while shared state s
+ *        changes to s', as it stays put. A spawn keeps its source, too.
+ */
+void backward_search::close_forward() {
+    const size_t S = thread_state::S;
+    /// the local states that can occur under each shared state
+    vector<vector<local_state>> locals(S);
+    deque<thread_state> W; /// the new thread states
+    auto add = [&](const shared_state& s, const local_state& l) {
+        const size_t v = size_t(s) * L + l;
+        if (!occurring[v]) {
+            occurring[v] = true;
+            locals[s].push_back(l);
+            W.emplace_back(s, l);
+        }
+    };
+    /// the shared states s changes to, in an edge enabled by an occurring
+    /// thread state
+    vector<vector<shared_state>> changes(S);
+    vector<bool> is_change(S * S, false);
+    add(refs::INITL_TS.get_share(), refs::INITL_TS.get_local());
+    while (!W.empty()) {
+        const thread_state src = W.front();
+        W.pop_front();
+        const shared_state& s = src.get_share();
+        /// a new thread state stays put under the shared states s changes to
+        for (auto is = changes[s].begin(); is != changes[s].end(); ++is)
+            add(*is, src.get_local());
+        const auto& succ = refs::original_TTD.successors(src);
+        for (auto ie = succ.begin(); ie != succ.end(); ++ie) {
+            const shared_state& _s = ie->dst.get_share();
+            add(_s, ie->dst.get_local());
+            if (ie->is_spawn)
+                add(_s, src.get_local());
+            if (_s == s || is_change[size_t(s) * S + _s])
+                continue;
+            /// a new change: all thread states under s can stay put
+            is_change[size_t(s) * S + _s] = true;
+            changes[s].push_back(_s);
+            for (size_t i = 0; i < locals[s].size(); ++i)
+                add(_s, locals[s][i]);
+        }
+    }
+}
+
+/**
+ * @brief whether all thread states of an element can occur, which all of
+ *        its reachable states need
+ * @param m
+ * @return bool
+ */
+bool backward_search::is_occurring(const uint32_t* m) const {
+    const size_t v = size_t(m[SHARE]) * L;
+    bool is_empty = true; /// then the shared state has to occur
+    for (size_t l = 0; l < L; ++l) {
+        if (m[COUNTERS + l] == 0)
+            continue;
+        if (!occurring[v + l])
+            return false;
+        is_empty = false;
+    }
+    if (is_empty)
+        for (size_t l = 0; l < L; ++l)
+            if (occurring[v + l])
+                return true;
+    return !is_empty;
+}
+
+/**
+ * @brief whether an element includes an initial state <s_0|(l_0, n)>
+ * @param m
+ * @return bool
+ */
+bool backward_search::is_initial(const uint32_t* m) const {
+    if (m[SHARE] != refs::INITL_TS.get_share())
+        return false;
+    for (size_t l = 0; l < L; ++l)
+        if (m[COUNTERS + l] > 0 && l != refs::INITL_TS.get_local())
+            return false;
+    return true;
+}
+
+/**
+ * @brief insert an element unless a basis element is below it, and evict
+ *        the basis elements above it
+ * @param m: the record of the element
+ * @return pair<id, bool>
+ *         first : the id of the element, if inserted
+ *         second: true if the element is inserted
+ */
+pair<backward_search::id, bool> backward_search::insert(const uint32_t* m) {
+    basis& b = bases[m[SHARE]];
+    const uint64_t sig = this->signature(m);
+    for (size_t i = 0; i < b.ids.size(); ++i)
+        if ((b.sigs[i] & ~sig) == 0
+                && this->below(this->record(b.ids[i]) + COUNTERS,
+                        m + COUNTERS)) {
+            ++n_pruned;
+            return std::make_pair(NONE, false);
+        }
+    for (size_t i = 0; i < b.ids.size();) {
+        if ((sig & ~b.sigs[i]) == 0
+                && this->below(m + COUNTERS,
+                        this->record(b.ids[i]) + COUNTERS)) {
+            evicted[b.ids[i]] = true;
+            ++n_evicted, --n_basis;
+            b.sigs[i] = b.sigs.back(), b.ids[i] = b.ids.back();
+            b.sigs.pop_back(), b.ids.pop_back();
+        } else {
+            ++i;
+        }
+    }
+    if (evicted.size() >= NONE)
+        throw ural_rt_err("backward_search: too many elements");
+    const id v = evicted.size();
+    nodes.insert(nodes.end(), m, m + width);
+    evicted.push_back(false);
+    b.sigs.push_back(sig), b.ids.push_back(v);
+    if (max_basis < ++n_basis)
+        max_basis = n_basis;
+    return std::make_pair(v, true);
+}
+
+/**
+ * @brief the signature of an element: bit l % 64 is set if local state l
+ *        is occupied. If u is below t, the bits of u are among those of t.
+ * @param m
+ * @return uint64_t
+ */
+uint64_t backward_search::signature(const uint32_t* m) const {
+    uint64_t sig = 0;
+    for (size_t l = 0; l < L; ++l)
+        if (m[COUNTERS + l] > 0)
+            sig |= uint64_t(1) << (l & 63);
+    return sig;
+}
+
+/**
+ * @brief print the chain of elements from an initial one to final: every
+ *        element reaches the upward closure of the next one by a transition
+ * @param v: an element including an initial state
+ */
+void backward_search::print_path(const id& v) const {
+    cout << "backward path:" << endl;
+    for (id u = v; u != NONE; u = this->record(u)[PARENT])
+        this->to_stream(cout << "  ", this->record(u)) << endl;
+}
+
+/**
+ * @brief print an element in the format of global_state
+ * @param out
+ * @param m
+ * @return ostream
+ */
+ostream& backward_search::to_stream(ostream& out, const uint32_t* m) const {
+    out << "<" << m[SHARE] << "|";
+    for (size_t l = 0; l < L; ++l)
+        if (m[COUNTERS + l] > 0)
+            out << "(" << l << "," << m[COUNTERS + l] << ")";
+    out << ">";
+    return out;
+}
+
+} /* namespace sura */
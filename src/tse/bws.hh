@@ -0,0 +1,113 @@
+/**
+ * @name bws.hh
+ *
+ * @brief the backward coverability search
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef BWS_HH_
+#define BWS_HH_
+
+#include "../util/refs.hh"
+
+namespace sura {
+
+/**
+ * @brief the backward search from the upward closure of final over the
+ *        thread-state transition diagram refs::original_TTD. An upward-
+ *        closed set of global states is represented by its minimal basis:
+ *        an element <s|c> stands for all states <s|c'> with c' >= c. The
+ *        pre-image of an element under a transition is again an element,
+ *        so the search adds the predecessors of the new elements level by
+ *        level, until the basis includes an initial state with any number
+ *        of threads or no element is new.
+ *
+ *        An element none of whose states is reachable is dropped: the search
+ *        first computes the thread states that can occur at all, by a cheap
+ *        forward closure in which a thread may also stay put while another
+ *        one changes the shared state.
+ *
+ *        The basis is indexed by shared state: a predecessor above a basis
+ *        element is pruned, and the basis elements above a predecessor are
+ *        evicted and not expanded anymore. Every basis element comes with a
+ *        signature of the local states it occupies, so that most elements
+ *        are ruled out by one AND before their counters are compared. The
+ *        represented set only grows, so the search terminates by Dickson's
+ *        lemma.
+ *
+ *        Elements are stored as flat records of L + 2 words in one array:
+ *        the shared state, the element whose pre-image it is and the L
+ *        counters. With refs::IS_BWS_TREE, the chain of elements from an
+ *        initial state to final is printed.
+ */
+class backward_search {
+public:
+    backward_search();
+    ~backward_search();
+
+    bool is_coverable();
+
+    ostream& print_stat(ostream& out = cout) const;
+
+private:
+    typedef uint32_t id;
+
+    static const id NONE; /// the parent of the final element
+
+    enum {
+        SHARE = 0, PARENT = 1, COUNTERS = 2 /// the fields of a record
+    };
+
+    /// an edge src -> <s|dst> or src +> <s|dst>, kept under s
+    struct edge {
+        thread_state src;
+        local_state dst;
+        bool is_spawn;
+    };
+
+    const size_t L;
+    const size_t width;   /// the words of a record
+    vector<vector<edge>> entering; /// the edges by their target shared state
+    vector<bool> occurring;        /// the thread states that can occur, by ID
+    vector<uint32_t> nodes;
+    vector<bool> evicted;     /// by element
+    /// the basis elements of a shared state and their signatures
+    struct basis {
+        vector<uint64_t> sigs;
+        vector<id> ids;
+    };
+    vector<basis> bases; /// by shared state
+
+    size_t n_iterations;
+    size_t n_pruned;
+    size_t n_unreachable;
+    size_t n_evicted;
+    size_t max_basis;
+    size_t n_basis;
+
+    inline const uint32_t* record(const id& v) const {
+        return nodes.data() + size_t(v) * width;
+    }
+
+    /// whether the counters u are below the counters t
+    inline bool below(const uint32_t* u, const uint32_t* t) const {
+        for (size_t l = 0; l < L; ++l)
+            if (u[l] > t[l])
+                return false;
+        return true;
+    }
+
+    void close_forward();
+    bool is_occurring(const uint32_t* m) const;
+    bool is_initial(const uint32_t* m) const;
+    uint64_t signature(const uint32_t* m) const;
+    pair<id, bool> insert(const uint32_t* m);
+    void print_path(const id& v) const;
+    ostream& to_stream(ostream& out, const uint32_t* m) const;
+};
+
+} /* namespace sura */
+
+#endif /* BWS_HH_ */
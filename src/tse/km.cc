@@ -0,0 +1,177 @@
+/**
+ * @name km.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "km.hh"
+
+namespace sura {
+
+const uint32_t karp_miller::OMEGA = std::numeric_limits<uint32_t>::max();
+const karp_miller::id karp_miller::NONE = std::numeric_limits<id>::max();
+
+/**
+ * @brief constructor: the empty tree over the current S and L
+ */
+karp_miller::karp_miller() :
+        L(thread_state::L), width(thread_state::L + COUNTERS), nodes(), evicted(), chains(
+                thread_state::S), n_pruned(0), n_evicted(0), n_accelerated(0) {
+}
+
+karp_miller::~karp_miller() {
+}
+
+/**
+ * @brief build the tree breadth first until a node covers final
+ * @return bool
+ * 		true : if final is coverable
+ * 		false: otherwise
+ */
+bool karp_miller::is_coverable() {
+    const shared_state& s_0 = refs::INITL_TS.get_share();
+    const local_state& l_0 = refs::INITL_TS.get_local();
+    const shared_state& s_F = refs::FINAL_TS.get_share();
+    const local_state& l_F = refs::FINAL_TS.get_local();
+    /// a thread state outside the TTD has no transition
+    if (s_0 >= thread_state::S || l_0 >= L)
+        return refs::FINAL_TS == refs::INITL_TS;
+    if (s_F >= thread_state::S || l_F >= L)
+        return false;
+
+    vector<uint32_t> M(width, 0), N(width);
+    M[SHARE] = s_0, M[PARENT] = NONE, M[COUNTERS + l_0] = OMEGA;
+    ring_queue<id> W; /// worklist
+    W.push(this->insert(M.data()).first);
+    bool is_reach = false;
+    while (!W.empty()) {
+        const id v = W.front();
+        W.pop();
+        if (evicted[v])
+            continue;
+        /// a copy, as inserting may move the records
+        std::memcpy(M.data(), this->record(v), width * sizeof(uint32_t));
+        const shared_state shared = M[SHARE];
+        if (shared == s_F && M[COUNTERS + l_F] >= refs::TARGET_THR_NUM) {
+            cout << refs::FINAL_TS << endl;
+            cout << "covering configuration: ";
+            this->to_stream(cout, M.data()) << endl;
+            is_reach = true;
+            break;
+        }
+        for (local_state l = 0; l < L; ++l) {
+            if (M[COUNTERS + l] == 0)
+                continue;
+            const auto& succ = refs::original_TTD.successors(
+                    thread_state(shared, l));
+            for (auto ie = succ.begin(); ie != succ.end(); ++ie) {
+                const local_state& inc = ie->dst.get_local();
+                N = M;
+                N[SHARE] = ie->dst.get_share(), N[PARENT] = v;
+                if (!ie->is_spawn && N[COUNTERS + l] != OMEGA)
+                    --N[COUNTERS + l];
+                if (N[COUNTERS + inc] == OMEGA - 1)
+                    throw ural_rt_err("karp_miller: counter overflow");
+                if (N[COUNTERS + inc] != OMEGA)
+                    ++N[COUNTERS + inc];
+                this->accelerate(v, N.data());
+                const auto& ins = this->insert(N.data());
+                if (ins.second)
+                    W.push(ins.first);
+            }
+        }
+    }
+
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL)
+        this->print_stat() << endl;
+    return is_reach;
+}
+
+ostream& karp_miller::print_stat(ostream& out) const {
+    size_t n_kept = 0;
+    for (auto ic = chains.begin(); ic != chains.end(); ++ic)
+        n_kept += ic->size();
+    out << "km: " << PPRINT::plural(evicted.size(), "node") << ", " << n_kept
+            << " kept, " << n_evicted << " evicted, " << n_pruned
+            << " pruned, " << PPRINT::plural(n_accelerated, "acceleration")
+            << ", " << nodes.size() * sizeof(uint32_t) / 1024
+            << " KiB of nodes";
+    return out;
+}
+
+/**
+ * @brief set to omega every counter of a new node that exceeds the counter
+ *        of an ancestor covered by the node, with the same shared state:
+ *        the path from the ancestor can be repeated to pump it
+ * @param parent: the parent of the new node
+ * @param m     : the record of the new node
+ */
+void karp_miller::accelerate(const id& parent, uint32_t* m) {
+    for (id a = parent; a != NONE; a = this->record(a)[PARENT]) {
+        const uint32_t* r = this->record(a);
+        if (r[SHARE] != m[SHARE]
+                || !this->covers(m + COUNTERS, r + COUNTERS))
+            continue;
+        for (size_t l = 0; l < L; ++l)
+            if (m[COUNTERS + l] > r[COUNTERS + l]
+                    && m[COUNTERS + l] != OMEGA) {
+                m[COUNTERS + l] = OMEGA;
+                ++n_accelerated;
+            }
+    }
+}
+
+/**
+ * @brief insert a node unless a kept node covers it, and evict the kept
+ *        nodes it covers
+ * @param m: the record of the node
+ * @return pair<id, bool>
+ *         first : the id of the node, if kept
+ *         second: true if the node is kept
+ */
+pair<karp_miller::id, bool> karp_miller::insert(const uint32_t* m) {
+    vector<id>& c = chains[m[SHARE]];
+    for (auto iv = c.begin(); iv != c.end(); ++iv)
+        if (this->covers(this->record(*iv) + COUNTERS, m + COUNTERS)) {
+            ++n_pruned;
+            return std::make_pair(NONE, false);
+        }
+    for (size_t i = 0; i < c.size();) {
+        if (this->covers(m + COUNTERS, this->record(c[i]) + COUNTERS)) {
+            evicted[c[i]] = true;
+            ++n_evicted;
+            c[i] = c.back();
+            c.pop_back();
+        } else {
+            ++i;
+        }
+    }
+    if (evicted.size() >= NONE)
+        throw ural_rt_err("karp_miller: too many nodes");
+    const id v = evicted.size();
+    nodes.insert(nodes.end(), m, m + width);
+    evicted.push_back(false);
+    c.push_back(v);
+    return std::make_pair(v, true);
+}
+
+/**
+ * @brief print a node in the format of global_state, with w for omega
+ * @param out
+ * @param m
+ * @return ostream
+ */
+ostream& karp_miller::to_stream(ostream& out, const uint32_t* m) const {
+    out << "<" << m[SHARE] << "|";
+    for (size_t l = 0; l < L; ++l) {
+        if (m[COUNTERS + l] == OMEGA)
+            out << "(" << l << ",w)";
+        else if (m[COUNTERS + l] > 0)
+            out << "(" << l << "," << m[COUNTERS + l] << ")";
+    }
+    out << ">";
+    return out;
+}
+
+} /* namespace sura */
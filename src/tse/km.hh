@@ -0,0 +1,84 @@
+/**
+ * @name km.hh
+ *
+ * @brief the Karp-Miller coverability engine
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef KM_HH_
+#define KM_HH_
+
+#include "../util/refs.hh"
+#include "../util/arena.hh"
+
+namespace sura {
+
+/**
+ * @brief the Karp-Miller coverability tree of the thread-state transition
+ *        diagram refs::original_TTD, with any number of threads starting in
+ *        refs::INITL_TS: its root has an omega counter on the initial local
+ *        state. A node is a global state whose counters may be omega, i.e.,
+ *        arbitrarily large. The counters of a new node that exceed those of
+ *        an ancestor with the same shared state are accelerated to omega,
+ *        which makes the tree finite, also with spawns.
+ *
+ *        Only a minimal coverability set is kept: a new node covered by a
+ *        kept one is pruned, and the kept nodes it covers are evicted and
+ *        not expanded anymore. Final is coverable iff a kept node covers it
+ *        with refs::TARGET_THR_NUM threads, so unlike the CEGAR loop, the
+ *        construction always terminates with an answer.
+ *
+ *        Nodes are stored as flat records of L + 2 words in one array: the
+ *        shared state, the parent and the L counters.
+ */
+class karp_miller {
+public:
+    karp_miller();
+    ~karp_miller();
+
+    bool is_coverable();
+
+    ostream& print_stat(ostream& out = cout) const;
+
+private:
+    typedef uint32_t id;
+
+    static const uint32_t OMEGA; /// greater than every finite counter
+    static const id NONE;        /// the parent of the root
+
+    enum {
+        SHARE = 0, PARENT = 1, COUNTERS = 2 /// the fields of a record
+    };
+
+    const size_t L;
+    const size_t width; /// the words of a record
+    vector<uint32_t> nodes;
+    vector<bool> evicted;      /// by node
+    vector<vector<id>> chains; /// the kept nodes by shared state
+
+    size_t n_pruned;
+    size_t n_evicted;
+    size_t n_accelerated;
+
+    inline const uint32_t* record(const id& v) const {
+        return nodes.data() + size_t(v) * width;
+    }
+
+    /// whether the counters u cover the counters t
+    inline bool covers(const uint32_t* u, const uint32_t* t) const {
+        for (size_t l = 0; l < L; ++l)
+            if (u[l] < t[l])
+                return false;
+        return true;
+    }
+
+    void accelerate(const id& parent, uint32_t* m);
+    pair<id, bool> insert(const uint32_t* m);
+    ostream& to_stream(ostream& out, const uint32_t* m) const;
+};
+
+} /* namespace sura */
+
+#endif /* KM_HH_ */
@@ -9,16 +9,47 @@
 
 namespace sura {
 
+const size_t tse::PACKED_MAX_WORDS = 8;
+
+/**
+ * @brief constructor for streaming encoding: transitions are added batch by
+ *        batch via encode, once the header has set S and L
+ */
+tse::tse() :
+        ctx(), n_0(ctx.int_const("n0")), x_affix("x"), x_vars(), l_rows(), s_rows(
+                ), sum_z(ctx.int_val(0)), max_n(0), max_z(0), s_solver(
+                (tactic(ctx, "simplify") & tactic(ctx, "solve-eqs")
+                        & tactic(ctx, "smt")).mk_solver()), fws_states(), fws_n(
+                0), is_refinable(true) {
+    /// add n_0 >= 1
+    s_solver.add(n_0 >= 1);
+    for (size_t i = 0; i < thread_state::L; ++i) {
+        l_rows.in.emplace_back(ctx);
+        l_rows.out.emplace_back(ctx);
+    }
+    for (size_t i = 0; i < thread_state::S; ++i) {
+        s_rows.in.emplace_back(ctx);
+        s_rows.out.emplace_back(ctx);
+    }
+}
+
 tse::tse(const id_tran &size_R, const deque<id_tran>& spawns) :
-        ctx(), n_0(ctx.int_const("n0")), x_affix("x"), x_index(size_R), sum_z(
-                ctx.int_val(0)), max_n(0), max_z(0), s_solver(
+        ctx(), n_0(ctx.int_const("n0")), x_affix("x"), x_vars(), l_rows(), s_rows(
+                ), sum_z(ctx.int_val(0)), max_n(0), max_z(0), s_solver(
                 (tactic(ctx, "simplify") & tactic(ctx, "solve-eqs")
-                        & tactic(ctx, "smt")).mk_solver()) {
-    /// set up the expression of summarizing all spawn variables
-    for (auto iv = spawns.begin(); iv != spawns.end(); ++iv) {
-        const id_tran& id = *iv;
-        sum_z = sum_z + ctx.int_const((x_affix + std::to_string(id)).c_str());
+                        & tactic(ctx, "smt")).mk_solver()), fws_states(), fws_n(
+                0), is_refinable(true) {
+    /// add n_0 >= 1
+    s_solver.add(n_0 >= 1);
+    x_vars.reserve(size_R);
+    for (id_tran id = 0; id < size_R; ++id) {
+        x_vars.emplace_back(
+                ctx.int_const((x_affix + std::to_string(id)).c_str()));
+        s_solver.add(x_vars.back() >= 0); /// add x_i >= 0
     }
+    /// set up the expression of summarizing all spawn variables
+    for (auto iv = spawns.begin(); iv != spawns.end(); ++iv)
+        sum_z = sum_z + x_vars[*iv];
 }
 
 tse::~tse() {
@@ -26,49 +57,129 @@ tse::~tse() {
 
 /**
  * @brief determine the reachability of FINAL_TS via TSE
- * @param l_in_out
- * @param s_in_out
+ * @param l_matrix: the incidence matrix of local  states
+ * @param s_matrix: the incidence matrix of shared states
+ * @return bool
+ * 		true : if reachable
+ * 		false: otherwise
+ */
+bool tse::reachability_analysis_via_tse(const incidence& l_matrix,
+        const incidence& s_matrix) {
+    l_rows = this->rows_of(l_matrix);
+    s_rows = this->rows_of(s_matrix);
+    return this->reachability_analysis_via_tse();
+}
+
+/**
+ * @brief determine the reachability of FINAL_TS via TSE after all of the
+ *        transitions are encoded. The rows are released once the
+ *        constraints are built from them.
  * @return bool
  * 		true : if reachable
  * 		false: otherwise
  */
-bool tse::reachability_analysis_via_tse(const vector<inout>& l_in_out,
-        const vector<inout>& s_in_out) {
-    switch (this->solicit_for_TSE(l_in_out, s_in_out)) {
+bool tse::reachability_analysis_via_tse() {
+    /// the final thread state has no row if no transition can touch it
+    if (!(refs::FINAL_TS == refs::INITL_TS)
+            && (refs::FINAL_TS.get_share() >= thread_state::S
+                    || refs::FINAL_TS.get_local() >= thread_state::L))
+        return false;
+    switch (this->solicit_for_TSE()) {
     case result::reach:
         return true;
     case result::unreach:
         return false;
     default: /// unknown
+        if (refs::OPT_BACKWARD) /// instead of the CEGAR loop
+            return backward_search().is_coverable();
+        if (refs::OPT_ENGINE == "km")
+            return karp_miller().is_coverable();
         return this->solicit_for_CEGAR();
     }
 }
 
 /**
- * @brief solicit reachability for Thread State Equation
- * @param l_in_out
- * @param s_in_out
- * @return
+ * @brief encode a batch of transitions as it arrives: the variable of every
+ *        transition is created, constrained to x_i >= 0 and added to the
+ *        rows of the states it enters and leaves. A transition that keeps
+ *        its shared state is in no row of shared states.
+ * @param batch
  */
-result tse::solicit_for_TSE(const vector<inout>& l_in_out,
-        const vector<inout>& s_in_out) {
-    /// add n_0 >= 1
-    s_solver.add(n_0 >= 1);
+void tse::encode(const tran_batch& batch) {
+    if (batch.first != x_vars.size())
+        throw ural_rt_err("encode: batches out of order");
+    for (auto it = batch.trans.begin(); it != batch.trans.end(); ++it) {
+        x_vars.emplace_back(
+                ctx.int_const(
+                        (x_affix + std::to_string(x_vars.size())).c_str()));
+        const expr& x = x_vars.back();
+        s_solver.add(x >= 0);
+        if (it->flags & ttdb_tran::SPAWN)
+            sum_z = sum_z + x;
+        l_rows.in[it->l2].push_back(x);
+        l_rows.out[it->l1].push_back(x);
+        if (it->s1 != it->s2) {
+            s_rows.in[it->s2].push_back(x);
+            s_rows.out[it->s1].push_back(x);
+        }
+    }
+}
 
-    /// add x_i >= 0
-    for (uint idx = 0; idx < x_index; ++idx)
-        s_solver.add(
-                ctx.int_const((x_affix + std::to_string(idx)).c_str()) >= 0);
+/**
+ * @brief the rows of an incidence matrix as terms of the equation
+ * @param matrix
+ * @return eq_rows
+ */
+eq_rows tse::rows_of(const incidence& matrix) {
+    eq_rows rows;
+    for (size_t v = 0; v < matrix.rows(); ++v) {
+        rows.in.emplace_back(ctx);
+        const auto& in = matrix.in(v);
+        for (auto iv = in.begin(); iv != in.end(); ++iv)
+            rows.in.back().push_back(x_vars[*iv]);
+        rows.out.emplace_back(ctx);
+        const auto& out = matrix.out(v);
+        for (auto iv = out.begin(); iv != out.end(); ++iv)
+            rows.out.back().push_back(x_vars[*iv]);
+    }
+    return rows;
+}
+
+/**
+ * @brief the sum of the given terms plus a constant term, as one n-ary sum
+ * @param terms
+ * @param c    : the constant term, omitted if 0
+ * @return expr
+ */
+expr tse::sum_of(const expr_vector& terms, const expr& c) {
+    expr_vector all(ctx);
+    if (!c.is_numeral() || c.get_numeral_int() != 0)
+        all.push_back(c);
+    for (unsigned i = 0; i < terms.size(); ++i)
+        all.push_back(terms[i]);
+    if (all.empty())
+        return ctx.int_val(0);
+    return all.size() == 1 ? all[0] : sum(all);
+}
 
+/**
+ * @brief solicit reachability for Thread State Equation. n_0 >= 1 and
+ *        x_i >= 0 are added as the variables are created; the rows are
+ *        released once C_L and C_S are built from them.
+ * @return
+ */
+result tse::solicit_for_TSE() {
     /// add C_L constraints
-    const auto& c_L = this->build_CL(l_in_out);
+    const auto& c_L = this->build_CL(l_rows);
     for (size_t i = 0; i != c_L.size(); ++i)
         s_solver.add(c_L[i]);
 
     /// add C_S constraints
-    const auto& c_S = this->build_CS(s_in_out);
+    const auto& c_S = this->build_CS(s_rows);
     for (size_t i = 0; i != c_S.size(); ++i)
         s_solver.add(c_S[i]);
+    l_rows = eq_rows();
+    s_rows = eq_rows();
 
 #ifndef NDEBUG
     for (auto iphi = c_L.begin(); iphi != c_L.end(); ++iphi)
@@ -79,7 +190,7 @@ result tse::solicit_for_TSE(const vector<inout>& l_in_out,
 
     if (refs::OPT_CONSTRAINT) { /// output constraints
         cout << "(declare-fun " << n_0 << " () Int)" << "\n";
-        for (uint idx = 0; idx < x_index; ++idx)
+        for (size_t idx = 0; idx < x_vars.size(); ++idx)
             cout << "(declare-fun " << x_affix << idx << " () Int)" << "\n";
         cout << "(assert \n";
         cout << s_solver << "\n";
@@ -91,60 +202,53 @@ result tse::solicit_for_TSE(const vector<inout>& l_in_out,
 }
 
 /**
- * @brief build local constraints C_L
- * @param l_in_out
+ * @brief build local constraints C_L: one per row of the incidence matrix,
+ *        the incoming transitions of a local state, plus n_0 at the initial
+ *        one, cover its outgoing transitions, plus the target threads at the
+ *        final one
+ * @param l_rows
  * @return
  */
-vec_expr tse::build_CL(const vector<inout>& l_in_out) {
-    vec_expr phi(thread_state::L, ctx.int_val(0));
-    phi[refs::INITL_TS.get_local()] = n_0;
-
-    for (size_t i = 0; i < l_in_out.size(); ++i) {
-        expr lhs(ctx.int_val(0)); // left-hand		side
-        expr rhs(ctx.int_val(0)); // right-hand 	side
-        if (i == refs::FINAL_TS.get_local())
-            rhs = ctx.int_val(refs::TARGET_THR_NUM);
-
-        for (auto inc = l_in_out[i].first.begin();
-                inc != l_in_out[i].first.end(); ++inc)
-            lhs = lhs + ctx.int_const((x_affix + std::to_string(*inc)).c_str());
-
-        for (auto out = l_in_out[i].second.begin();
-                out != l_in_out[i].second.end(); ++out)
-            rhs = rhs + ctx.int_const((x_affix + std::to_string(*out)).c_str());
-
-        phi[i] = (phi[i] + lhs) >= rhs;
+vec_expr tse::build_CL(const eq_rows& l_rows) {
+    if (l_rows.in.size() != thread_state::L)
+        throw ural_rt_err("build_CL: the incidence matrix mismatches L");
+    vec_expr phi;
+    phi.reserve(thread_state::L);
+    for (size_t i = 0; i < thread_state::L; ++i) {
+        const expr inc = this->sum_of(l_rows.in[i],
+                i == refs::INITL_TS.get_local() ? n_0 : ctx.int_val(0));
+        const expr out = this->sum_of(l_rows.out[i],
+                i == refs::FINAL_TS.get_local() ?
+                        ctx.int_val(refs::TARGET_THR_NUM) : ctx.int_val(0));
+        phi.emplace_back(inc >= out);
     }
     DBG_LOC();
     return phi;
 }
 
 /**
- * @brief build shared constraints C_S
- * @param s_in_out
+ * @brief build shared constraints C_S: one per row of the incidence matrix,
+ *        the incoming transitions of a shared state balance its outgoing
+ *        ones, plus 1 at the initial and -1 at the final one if they differ
+ * @param s_rows
  * @return
  */
-vec_expr tse::build_CS(const vector<inout>& s_in_out) {
-    vec_expr phi(thread_state::S, ctx.int_val(0));
-
-    if (refs::INITL_TS.get_share() != refs::FINAL_TS.get_share()) {
-        phi[refs::INITL_TS.get_share()] = ctx.int_val(1);
-        phi[refs::FINAL_TS.get_share()] = ctx.int_val(-1);
-    }
-
-    for (size_t i = 0; i < s_in_out.size(); ++i) {
-        expr lhs(ctx.int_val(0)); // left-hand 	side
-        expr rhs(ctx.int_val(0)); // right-hand 	side
-
-        for (auto inc = s_in_out[i].first.begin();
-                inc != s_in_out[i].first.end(); ++inc)
-            lhs = lhs + ctx.int_const((x_affix + std::to_string(*inc)).c_str());
-
-        for (auto out = s_in_out[i].second.begin();
-                out != s_in_out[i].second.end(); ++out)
-            rhs = rhs + ctx.int_const((x_affix + std::to_string(*out)).c_str());
-
-        phi[i] = (phi[i] + lhs) == rhs;
+vec_expr tse::build_CS(const eq_rows& s_rows) {
+    if (s_rows.in.size() != thread_state::S)
+        throw ural_rt_err("build_CS: the incidence matrix mismatches S");
+    const bool is_moved = refs::INITL_TS.get_share()
+            != refs::FINAL_TS.get_share();
+    vec_expr phi;
+    phi.reserve(thread_state::S);
+    for (size_t i = 0; i < thread_state::S; ++i) {
+        int c = 0;
+        if (is_moved && i == refs::INITL_TS.get_share())
+            c = 1;
+        else if (is_moved && i == refs::FINAL_TS.get_share())
+            c = -1;
+        phi.emplace_back(
+                this->sum_of(s_rows.in[i], ctx.int_val(c))
+                        == this->sum_of(s_rows.out[i], ctx.int_val(0)));
     }
     DBG_LOC();
     return phi;
@@ -159,6 +263,8 @@ result tse::check_sat_via_smt_solver() {
     switch (s_solver.check()) {
     case sat:
         this->parse_sat_solution(s_solver.get_model());
+        if (refs::OPT_BACKWARD || refs::OPT_ENGINE == "km")
+            return result::unknown; /// decided by a complete search
         if (check_reach_with_fixed_threads(max_n, max_z))
             return result::reach;
         return result::unknown;
@@ -211,13 +317,19 @@ uint tse::get_z3_const_uint(const expr& e) {
 }
 
 /**
- * @brief solicit for CEGAR to refine pathwise encoding
+ * @brief solicit for CEGAR to refine pathwise encoding. The CEGAR loop
+ *        might never terminate, so after refs::OPT_REFINEMENTS rounds, if
+ *        nonzero, the Karp-Miller tree decides.
  * @return bool
  * 		true : if we find a witness path,
  * 		false: otherwise
  */
 bool tse::solicit_for_CEGAR() {
-    while (true) { /// CEGAR loop might never terminate
+    for (uint round = 0;
+            refs::OPT_REFINEMENTS == 0 || round < refs::OPT_REFINEMENTS;
+            ++round) {
+        is_refinable = refs::OPT_REFINEMENTS == 0
+                || round + 1 < refs::OPT_REFINEMENTS;
         /// add incremental constraint
         s_solver.add(n_0 > ctx.int_val(max_n));
         if (max_z > 0 && !sum_z.is_int())
@@ -233,7 +345,7 @@ bool tse::solicit_for_CEGAR() {
             break;
         }
     }
-    return false;
+    return karp_miller().is_coverable();
 }
 
 /**
@@ -247,13 +359,18 @@ bool tse::solicit_for_CEGAR() {
  * 		false: otherwise
  */
 bool tse::check_reach_with_fixed_threads(const uint& n, const uint& z) {
+    const std::atomic<bool> is_never(false);
     /// if there is no spwan transitions, so call standard_FWS
     if (!refs::is_exists_SPAWN)
-        return this->standard_FWS(n, z);
+        return this->explore(n, z, fws_task { cout, is_never });
+
+    /// the searches below are independent of each other
+    if (refs::OPT_THREADS > 1 && n > 2)
+        return this->parallel_explore(n, z);
 
     /// enumeratively calling standard_FWS over (1, z) ... (n, ..., z)
     for (unsigned in = 1; in < n; ++in) {
-        if (this->standard_FWS(in, z))
+        if (this->explore(in, z, fws_task { cout, is_never }))
             return true;
     }
 
@@ -265,142 +382,1230 @@ bool tse::check_reach_with_fixed_threads(const uint& n, const uint& z) {
     return false;
 }
 
+/**
+ * @brief the enumeration of check_reach_with_fixed_threads on a pool of
+ *        refs::OPT_THREADS workers: the searches with 1, ..., n - 1 initial
+ *        threads are handed out in this order, so the small ones, which are
+ *        cheaper and yield shorter witnesses, start first. Once a search
+ *        with in threads finds a witness, the searches with more threads are
+ *        cancelled and the ones with fewer still run to their end.
+ *
+ *        Every search writes its report into a buffer of its own; the
+ *        reports are printed in the order of the sequential enumeration, up
+ *        to the least in with a witness, so the output is the same.
+ * @param n: # of initial   threads
+ * @param z: # of spawn transitions
+ * @return bool
+ * 		true : if there is a witness path
+ * 		false: otherwise
+ */
+bool tse::parallel_explore(const uint& n, const uint& z) {
+    vector<std::ostringstream> reports(n);
+    std::unique_ptr<std::atomic<bool>[]> is_cancelled(
+            new std::atomic<bool>[n]());
+    std::atomic<uint> next(1);  /// the next number of threads to search
+    std::atomic<uint> least(n); /// the least one with a witness so far
+
+    auto cancel_from = [&](const uint& from) {
+        for (uint i = from; i < n; ++i)
+            is_cancelled[i] = true;
+    };
+    auto search = [&]() {
+        uint in;
+        while ((in = next.fetch_add(1)) < least.load()) {
+            if (!this->explore(in, z,
+                    fws_task { reports[in], is_cancelled[in] }))
+                continue;
+            uint l = least.load();
+            while (in < l && !least.compare_exchange_weak(l, in))
+                ;
+            cancel_from(in + 1);
+        }
+    };
+
+    {
+        vector<std::unique_ptr<worker>> pool;
+        for (uint i = 1; i < std::min(refs::OPT_THREADS, n - 1); ++i)
+            pool.emplace_back(new worker([&]() {
+                try {
+                    search();
+                } catch (...) {
+                    cancel_from(1);
+                    throw;
+                }
+            }));
+        try {
+            search();
+        } catch (...) {
+            cancel_from(1);
+            throw; /// the pool joins the others on unwinding
+        }
+        for (auto iw = pool.begin(); iw != pool.end(); ++iw)
+            (*iw)->join();
+    }
+
+    for (uint in = 1; in < std::min(least.load() + 1, n); ++in)
+        cout << reports[in].str();
+    return least < n;
+}
+
+/**
+ * @brief the search with fixed threads selected by refs::OPT_ENGINE
+ * @param n: # of initial   threads
+ * @param z: # of spawn transitions
+ * @param task: the report stream and cancellation flag of the search
+ * @return bool
+ * 		true : if there is a witness path
+ * 		false: otherwise
+ */
+bool tse::explore(const uint& n, const uint& z, const fws_task& task) {
+    if (refs::OPT_ENGINE == "mdd")
+        return this->symbolic_FWS(n, z, task);
+    if (refs::OPT_ENGINE == "astar")
+        return this->directed_FWS(n, z, task);
+    return this->standard_FWS(n, z, task);
+}
+
+/**
+ * @brief whether the explicit search is reduced by persistent or sleep
+ *        sets. A reduction changes the search order, in which the budget of
+ *        spawns is spent, so only searches without spawns are reduced. The
+ *        sleep sets are kept by dense state ids, which compressed states
+ *        lack.
+ * @return bool
+ */
+static bool is_reduced_FWS() {
+    return (refs::OPT_POR || refs::OPT_SLEEP_SETS) && !refs::is_exists_SPAWN
+            && !refs::OPT_COMPRESS;
+}
+
+/**
+ * @brief whether the explicit search runs on several workers. The spawn
+ *        budget is shared by the whole search and consumed in its order, so
+ *        a search with spawns stays sequential, as does a compressed one
+ *        and a reduced one, whose proviso depends on the search order.
+ * @return bool
+ */
+static bool is_parallel_FWS() {
+    return refs::OPT_THREADS > 1 && !refs::is_exists_SPAWN
+            && !refs::OPT_COMPRESS && !is_reduced_FWS();
+}
+
+/**
+ * @brief whether the explicit search keeps only maximal states. Without
+ *        spawns, all states have the same number of threads, so none covers
+ *        another and the antichain would only slow the search down.
+ * @return bool
+ */
+static bool is_antichain_FWS() {
+    return refs::OPT_ANTICHAIN && refs::is_exists_SPAWN;
+}
+
+/**
+ * @brief what the searches over packed global states with B-bit counters
+ *        share: the initial state, the test for final and the successors of
+ *        a state, generated in place. The counters of local states without
+ *        outgoing edges are masked off by one AND per word with a mask of
+ *        the shared state, so only the enabled sources are visited.
+ */
+template<unsigned B>
+class packed_search {
+public:
+    typedef packed<B> P;
+
+    /**
+     * @brief constructor
+     * @param n  : # of initial threads
+     * @param lay: the layout of packed states
+     */
+    packed_search(const uint& n, const packed_layout& lay) :
+            lay(lay), k(lay.words), has_final(
+                    refs::FINAL_TS.get_share() < thread_state::S
+                            && refs::FINAL_TS.get_local() < thread_state::L), n_final(
+                    refs::TARGET_THR_NUM), tau_0(
+                    lay.words, 0), A(
+                    size_t(thread_state::S) * lay.words) {
+        P::set_share(tau_0.data(), lay, refs::INITL_TS.get_share());
+        P::set(tau_0.data(), lay, refs::INITL_TS.get_local(), n);
+        for (size_t s = 0; s < thread_state::S; ++s)
+            P::spread(refs::original_TTD.sources(s), lay, A.data() + s * k);
+    }
+
+    /// whether a state covers final with n_final threads
+    inline bool is_final(const uint64_t* w) const {
+        return has_final && P::share(w, lay) == refs::FINAL_TS.get_share()
+                && P::get(w, lay, refs::FINAL_TS.get_local()) >= n_final;
+    }
+
+    /// print final and a state covering it
+    ostream& report(ostream& out, const uint64_t* w) const {
+        out << refs::FINAL_TS << endl;
+        out << "covering configuration: ";
+        return P::to_stream(out, w, lay) << endl;
+    }
+
+    /**
+     * @brief generate the successors of T in place on Z, which equals T
+     *        before and after
+     * @param T
+     * @param Z
+     * @param E    : k words for the enabled sources
+     * @param visit: a callback visit(src, i, e), called while Z holds the
+     *               successor of T by the i-th edge e of src. It may change
+     *               Z, but has to undo its changes.
+     */
+    template<typename F>
+    void for_each_successor(const uint64_t* T, uint64_t* Z, uint64_t* E,
+            F visit) const {
+        const shared_state shared = P::share(T, lay);
+        const uint64_t* a = A.data() + shared * k;
+        for (size_t i = 0; i < k; ++i)
+            E[i] = T[i] & a[i];
+        P::for_each(E, lay, k, [&](const local_state& l, const uint64_t&) {
+            const thread_state src(shared, l);
+            const auto& succ = refs::original_TTD.successors(src);
+            for (size_t i = 0; i < succ.size(); ++i) {
+                const csr_edge& e = succ[i];
+                const local_state& inc = e.dst.get_local();
+                P::set_share(Z, lay, e.dst.get_share());
+                if (!e.is_spawn) /// a spawning thread stays in src
+                    P::dec(Z, lay, l);
+                P::inc(Z, lay, inc);
+                visit(src, i, e);
+                P::dec(Z, lay, inc);
+                if (!e.is_spawn)
+                    P::inc(Z, lay, l);
+            }
+            P::set_share(Z, lay, shared);
+            return true;
+        });
+    }
+
+    const packed_layout& lay;
+    const size_t k;
+    /// final has a counter only if it is within the TTD
+    const bool has_final;
+    /// the threads final needs, as in the equation, the Karp-Miller tree
+    /// and the backward search
+    const uint64_t n_final;
+    vector<uint64_t> tau_0; /// the initial state with n threads
+
+private:
+    vector<uint64_t> A; /// the counter fields of the sources by shared state
+};
+
 /**
  * @brief  standard bounded forward search
  * 	    This procedure checks the reachability of final thread state with
  * 		fixed number of threads, i.e., if there exists a path tau_0 ->* tau_F
  * 		s.t. tau_F covers final.
+ *
+ * 		The search is specialized by the number of threads, which bounds
+ * 		every counter: global states are bit-packed with 4-, 8-, 16- or
+ * 		32-bit counters if they fit in PACKED_MAX_WORDS words, and kept as
+ * 		Locals otherwise. Counters beyond 16 bits are always packed. With
+ * 		OPT_COMPRESS, packed states are stored as varints instead. With
+ * 		several workers, packed states are searched in parallel. With
+ * 		OPT_ANTICHAIN and spawns, only the maximal states are kept. With
+ * 		OPT_POR or OPT_SLEEP_SETS, packed states are searched with a
+ * 		partial-order reduction.
  * @param n: # of initial   threads
  * @param z: # of spawn transitions
+ * @param task: its report stream and cancellation flag
  * @return bool
  * 		true : if there is a witness path
  * 		false: otherwise
  */
-bool tse::standard_FWS(const uint& n, const uint& z) {
+bool tse::standard_FWS(const uint& n, const uint& z, const fws_task& task) {
+    if (is_antichain_FWS()) {
+        /// the top bit of every counter is left free for the comparisons,
+        /// and an extra counter holds the spawns left
+        const packed_layout lay(
+                packed_layout::counter_bits(2 * (uint64_t(n) + z)), 1);
+        switch (lay.bits) {
+        case 4:
+            return this->antichain_FWS<4>(n, z, lay, task);
+        case 8:
+            return this->antichain_FWS<8>(n, z, lay, task);
+        case 16:
+            return this->antichain_FWS<16>(n, z, lay, task);
+        default:
+            return this->antichain_FWS<32>(n, z, lay, task);
+        }
+    }
+    const packed_layout lay(packed_layout::counter_bits(uint64_t(n) + z));
+    if (lay.words > PACKED_MAX_WORDS && lay.bits <= 16
+            && !refs::OPT_COMPRESS && !is_parallel_FWS()
+            && !is_reduced_FWS())
+        return this->counter_FWS(n, z, task);
+    switch (lay.bits) {
+    case 4:
+        return this->packed_FWS<4>(n, z, lay, task);
+    case 8:
+        return this->packed_FWS<8>(n, z, lay, task);
+    case 16:
+        return this->packed_FWS<16>(n, z, lay, task);
+    default:
+        return this->packed_FWS<32>(n, z, lay, task);
+    }
+}
+
+/**
+ * @brief dispatch the packed search: parallel, reduced, or by the visited
+ *        set, compressed or specialized by the number of words per state
+ * @param n   : # of initial   threads
+ * @param z   : # of spawn transitions
+ * @param lay : the layout of packed states
+ * @param task: its report stream and cancellation flag
+ * @return bool
+ */
+template<unsigned B>
+bool tse::packed_FWS(const uint& n, const uint& z, const packed_layout& lay,
+        const fws_task& task) {
+    if (is_parallel_FWS())
+        return this->parallel_FWS<B>(n, z, lay, task);
+    if (is_reduced_FWS()) {
+        switch (lay.words) {
+        case 1:
+            return this->reduced_FWS<B, packed_set<1>>(n, z, lay, task);
+        case 2:
+            return this->reduced_FWS<B, packed_set<2>>(n, z, lay, task);
+        default:
+            return this->reduced_FWS<B, packed_set<0>>(n, z, lay, task);
+        }
+    }
+    if (refs::OPT_COMPRESS)
+        return this->packed_FWS<B, varint_set<B>>(n, z, lay, task);
+    switch (lay.words) {
+    case 1:
+        return this->packed_FWS<B, packed_set<1>>(n, z, lay, task);
+    case 2:
+        return this->packed_FWS<B, packed_set<2>>(n, z, lay, task);
+    default:
+        return this->packed_FWS<B, packed_set<0>>(n, z, lay, task);
+    }
+}
+
+/**
+ * @brief standard_FWS over packed global states with B-bit counters,
+ *        visited in a set of type V. It explores the states in the same
+ *        order as counter_FWS.
+ * @param n   : # of initial   threads
+ * @param z   : # of spawn transitions
+ * @param lay : the layout of packed states
+ * @param task: its report stream and cancellation flag
+ * @return bool
+ */
+template<unsigned B, typename V>
+bool tse::packed_FWS(const uint& n, const uint& z, const packed_layout& lay,
+        const fws_task& task) {
+    typedef packed<B> P;
     auto spw = z;
-//	cout << "fws: " << n << "               " << z << endl;
-    queue<global_state, list<global_state>> W; /// worklist
-    W.push(global_state(refs::INITL_TS, n)); /// start from the initial state with n threads
-    set<global_state> R; /// reachable global states
-    while (!W.empty()) {
-        global_state tau = W.front();
+    const packed_search<B> F(n, lay);
+    V R(lay, refs::OPT_HUGE_PAGES); /// reachable global states
+    const size_t k = R.words();
+    ring_queue<typename V::id> W; /// worklist
+    /// the expanded state, the scratch state on which successors are
+    /// generated in place and the enabled sources
+    vector<uint64_t> T(k), Z(k), E(k);
+
+    /// without spawns, the states of a complete search are kept for the
+    /// next one with more threads. The budget of spawns is spent in search
+    /// order, so the states of a search with spawns are not reusable. They
+    /// are not kept in the last CEGAR round, which nothing follows, nor
+    /// with compressed states, whose copy would double the memory.
+    const bool is_kept = !refs::is_exists_SPAWN && is_refinable
+            && !refs::OPT_COMPRESS;
+    sparse_states S; /// the states of this search, if is_kept
+    const uint m = fws_n;
+    size_t n_reused = 0;
+    bool is_reach = false;
+    if (m > 0 && m < n) { /// the last search kept its states
+        /// every state reachable with m threads is reachable with n, the
+        /// extra threads idling in the initial local state. Only a state
+        /// whose initial local state is empty has successors beyond them,
+        /// by moving an extra thread, so only these are expanded again.
+        /// The extra threads may make any state cover final, though, if
+        /// final is in the initial local state, so all of them are tested.
+        const local_state& l_0 = refs::INITL_TS.get_local();
+        for (size_t pos = 0; pos < fws_states.end();) {
+            fws_states.load<B>(pos, T.data(), lay);
+            const uint64_t c = P::get(T.data(), lay, l_0);
+            P::set(T.data(), lay, l_0, c + n - m);
+            const auto& ins = R.insert(T.data());
+            if (F.is_final(T.data())) {
+                F.report(task.out, T.data());
+                is_reach = true;
+                break;
+            }
+            if (c == 0)
+                W.push(ins.first);
+            else if (is_kept)
+                S.append<B>(T.data(), lay);
+        }
+        fws_states.clear();
+        fws_n = 0;
+        n_reused = R.size();
+    } else {
+        W.push(R.insert(F.tau_0.data()).first);
+    }
+
+    while (!is_reach && !W.empty()
+            && !task.is_cancelled.load(std::memory_order_relaxed)) {
+        R.load(W.front(), T.data());
         W.pop();
-        const ushort &shared = tau.get_share();
-        for (auto il = tau.get_locals().begin(); il != tau.get_locals().end();
-                ++il) {
-            thread_state src(shared, il->first);
-            if (src != refs::FINAL_TS) {
-                auto ifind = refs::original_TTD.find(src);
-                if (ifind != refs::original_TTD.end()) {
-                    for (auto idst = ifind->second.begin();
-                            idst != ifind->second.end(); ++idst) {
-                        auto locals = tau.get_locals();
-                        if (refs::is_exists_SPAWN
-                                && this->is_spawn_transition(src, *idst)) { /// if src +> dst true
-                            if (spw > 0) {
-                                spw--;
-                                locals = this->update_counter(locals,
-                                        idst->get_local());
-                            } else { /// if the we already spawn z times, we can't
-                                continue; /// spawn any more and have to skip src +> dst;
-                            }
-                        } else {
-                            locals = this->update_counter(locals,
-                                    src.get_local(), idst->get_local());
-                        }
-                        global_state _tau(idst->get_share(), locals);
-                        if (R.insert(_tau).second) {
-                            /// record _tau's predecessor tau: for witness
-                            //_tau.pi = std::make_shared<Global_State>(tau);
-                            W.push(_tau);
-                        }
+        if (F.is_final(T.data())) {
+            F.report(task.out, T.data());
+            is_reach = true;
+            break;
+        }
+        if (is_kept)
+            S.append<B>(T.data(), lay);
+        std::memcpy(Z.data(), T.data(), k * sizeof(uint64_t));
+        F.for_each_successor(T.data(), Z.data(), E.data(),
+                [&](const thread_state&, const size_t&, const csr_edge& e) {
+                    if (e.is_spawn) { /// if src +> dst true
+                        if (spw == 0) /// no more spawns: skip src +> dst
+                            return;
+                        spw--;
+                    }
+                    const auto& ins = R.insert(Z.data());
+                    if (ins.second)
+                        W.push(ins.first);
+                });
+    }
+    if (is_kept && !is_reach
+            && !task.is_cancelled.load(std::memory_order_relaxed)) {
+        fws_states.swap(S);
+        fws_n = n;
+    }
+
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL) {
+        task.out << "fws with " << PPRINT::plural(n, "thread") << ", " << B
+                << "-bit counters in " << PPRINT::plural(k, "word") << ": ";
+        R.print_stat(task.out) << endl;
+        if (n_reused > 0)
+            task.out << "reused: " << n_reused
+                    << " states of the search with "
+                    << PPRINT::plural(m, "thread") << endl;
+    }
+    return is_reach;
+}
+
+/**
+ * @brief standard_FWS over packed global states with B-bit counters that
+ *        keeps only the maximal states: a successor covered by a visited
+ *        state with the same shared state is dropped, and the visited states
+ *        it covers are evicted and not expanded, if they are still queued.
+ *        Final is covered by a reachable state iff it is covered by a
+ *        maximal one.
+ *
+ *        Unlike packed_FWS, every state carries the spawns left on its path
+ *        in the extra counter c_L, as a budget spent in search order would
+ *        let a state expanded late cover, and evict, one that still has the
+ *        spawns to reach final. A state with fewer spawns left covers none.
+ * @param n   : # of initial   threads
+ * @param z   : # of spawn transitions
+ * @param lay : a layout whose counters keep their top bit free, with one
+ *              extra counter
+ * @param task: its report stream and cancellation flag
+ * @return bool
+ */
+template<unsigned B>
+bool tse::antichain_FWS(const uint& n, const uint& z, const packed_layout& lay,
+        const fws_task& task) {
+    typedef packed<B> P;
+    const local_state spw = thread_state::L; /// the counter of spawns left
+    packed_search<B> F(n, lay);
+    P::set(F.tau_0.data(), lay, spw, z);
+    packed_antichain<B> R(lay); /// maximal reachable global states
+    const size_t k = R.words();
+    ring_queue<typename packed_antichain<B>::id> W; /// worklist
+    vector<uint64_t> T(k), Z(k), E(k);
+
+    W.push(R.insert(F.tau_0.data()).first);
+    bool is_reach = false;
+    size_t n_skipped = 0; /// the evicted states dequeued
+    while (!W.empty() && !task.is_cancelled.load(std::memory_order_relaxed)) {
+        const auto i_T = W.front();
+        W.pop();
+        if (R.is_evicted(i_T)) {
+            ++n_skipped;
+            continue;
+        }
+        R.load(i_T, T.data());
+        if (F.is_final(T.data())) {
+            P::set(T.data(), lay, spw, 0);
+            F.report(task.out, T.data());
+            is_reach = true;
+            break;
+        }
+        std::memcpy(Z.data(), T.data(), k * sizeof(uint64_t));
+        const bool has_spawn = P::get(T.data(), lay, spw) > 0;
+        F.for_each_successor(T.data(), Z.data(), E.data(),
+                [&](const thread_state&, const size_t&, const csr_edge& e) {
+                    if (e.is_spawn) { /// if src +> dst true
+                        if (!has_spawn) /// no more spawns on this path
+                            return;
+                        P::dec(Z.data(), lay, spw);
                     }
+                    const auto& ins = R.insert(Z.data());
+                    if (e.is_spawn)
+                        P::inc(Z.data(), lay, spw);
+                    if (ins.second)
+                        W.push(ins.first);
+                });
+    }
+
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL) {
+        task.out << "fws with " << PPRINT::plural(n, "thread") << ", " << B
+                << "-bit counters in " << PPRINT::plural(k, "word") << ": ";
+        R.print_stat(task.out) << ", "
+                << PPRINT::plural(n_skipped, "evicted state")
+                << " not expanded" << endl;
+    }
+    return is_reach;
+}
+
+/**
+ * @brief standard_FWS over packed global states with B-bit counters, with
+ *        a partial-order reduction of the thread-local transitions, i.e.,
+ *        those that leave the shared state as is.
+ *
+ *        With OPT_POR, a state in which a thread is in a local state l
+ *        whose only transition, under every shared state, moves it to the
+ *        same l' != l fires just that transition: it is a persistent set,
+ *        as no other transition disables it, is disabled by it or fails to
+ *        commute with it. Of these, the one with the least l is fired,
+ *        unless l or l' is final's local state. If its successor is visited
+ *        already, the state is expanded in full, so that every cycle has a
+ *        fully expanded state and no transition is postponed forever.
+ *
+ *        With OPT_SLEEP_SETS, every state keeps a sleep set of the local
+ *        transitions that need not be fired from it: the local transitions
+ *        of other local states fired before t from the same state commute
+ *        with t, and so are asleep in the successor by t. A state reached
+ *        again with a smaller sleep set is expanded again by the woken
+ *        transitions. Sleep sets visit all states but fire fewer
+ *        transitions; they cover the first 64 edges of every shared state.
+ * @param n   : # of initial   threads
+ * @param z   : # of spawn transitions, 0 as spawns are not reduced
+ * @param lay : the layout of packed states
+ * @param task: its report stream and cancellation flag
+ * @return bool
+ */
+template<unsigned B, typename V>
+bool tse::reduced_FWS(const uint& n, const uint& z, const packed_layout& lay,
+        const fws_task& task) {
+    typedef packed<B> P;
+    const size_t S = thread_state::S, L = thread_state::L;
+    const packed_search<B> F(n, lay);
+    V R(lay, refs::OPT_HUGE_PAGES); /// reachable global states
+    const size_t k = R.words();
+    ring_queue<typename V::id> W; /// worklist
+    vector<uint64_t> T(k), Z(k), E(k);
+
+    /// the thread-local action of every local state, L if it has none, and
+    /// the counter fields of the local states that have one
+    vector<local_state> act(L, L);
+    vector<uint64_t> X(k, 0);
+    if (refs::OPT_POR) {
+        vector<uint64_t> bits((L + 63) / 64, 0);
+        for (local_state l = 0; l < L; ++l) {
+            local_state _l = L;
+            for (shared_state s = 0; s < S; ++s) {
+                const auto& succ = refs::original_TTD.successors(
+                        thread_state(s, l));
+                if (succ.size() != 1 || succ[0].is_spawn
+                        || succ[0].dst.get_share() != s
+                        || succ[0].dst.get_local() == l
+                        || (s > 0 && succ[0].dst.get_local() != _l)) {
+                    _l = L;
+                    break;
                 }
-            } else { /// if src == final
-                cout << src << endl;
-                cout << "covering configuration: " << tau << endl;
-                // this->reproduce_witness_path(tau.pi);
-                return true;
+                _l = succ[0].dst.get_local();
             }
+            if (F.has_final && (l == refs::FINAL_TS.get_local()
+                    || _l == refs::FINAL_TS.get_local()))
+                continue; /// a visible transition
+            act[l] = _l;
+            if (_l < L)
+                bits[l >> 6] |= uint64_t(1) << (l & 63);
         }
+        P::spread(bits.data(), lay, X.data());
     }
-    return false;
+
+    /// the position of the first edge of every thread state among the
+    /// edges of its shared state: edge i of <s|l> is bit first[<s|l>] + i
+    /// of a sleep set under s
+    vector<uint32_t> first(S * L, 0);
+    for (size_t s = 0, v = 0; s < S; ++s) {
+        uint32_t pos = 0;
+        for (local_state l = 0; l < L; ++l, ++v) {
+            first[v] = pos;
+            pos += refs::original_TTD.successors(thread_state(s, l)).size();
+        }
+    }
+    /// the bits of the edges of thread state v, which depend on each other
+    auto edges_of = [&](const size_t& v, const size_t& d) {
+        const uint32_t& f = first[v];
+        if (f >= 64 || d == 0)
+            return uint64_t(0);
+        const uint64_t m = f + d >= 64 ? ~uint64_t(0) :
+                (uint64_t(1) << (f + d)) - 1;
+        return m & ~((uint64_t(1) << f) - 1);
+    };
+
+    /// by state id: the sleep set, the woken transitions not fired yet and
+    /// whether it is expanded, if OPT_SLEEP_SETS
+    const bool is_sleep = refs::OPT_SLEEP_SETS;
+    vector<uint64_t> sleep, woken;
+    vector<bool> expanded;
+    size_t n_expanded = 0, n_persistent = 0, n_fired = 0, n_asleep = 0,
+            n_woken = 0;
+    /// visit the successor Z, whose sleep set is zz
+    auto visit = [&](const uint64_t& zz) {
+        ++n_fired;
+        const auto& ins = R.insert(Z.data());
+        if (ins.second) {
+            W.push(ins.first);
+            if (is_sleep) {
+                sleep.push_back(zz);
+                woken.push_back(0);
+                expanded.push_back(false);
+            }
+        } else if (is_sleep) {
+            const uint64_t wake = sleep[ins.first] & ~zz;
+            if (wake != 0) {
+                sleep[ins.first] &= zz;
+                if (expanded[ins.first]) {
+                    if (woken[ins.first] == 0)
+                        W.push(ins.first);
+                    woken[ins.first] |= wake;
+                }
+            }
+        }
+        return ins.second;
+    };
+
+    W.push(R.insert(F.tau_0.data()).first);
+    if (is_sleep) {
+        sleep.push_back(0);
+        woken.push_back(0);
+        expanded.push_back(false);
+    }
+    bool is_reach = false;
+    while (!W.empty() && !task.is_cancelled.load(std::memory_order_relaxed)) {
+        const auto j = W.front();
+        W.pop();
+        R.load(j, T.data());
+        if (F.is_final(T.data())) {
+            F.report(task.out, T.data());
+            is_reach = true;
+            break;
+        }
+        const shared_state shared = P::share(T.data(), lay);
+        /// the woken transitions if expanded again, and the sleep set
+        const bool is_woken = is_sleep && expanded[j];
+        uint64_t wake = 0, zz = 0;
+        if (is_woken) {
+            wake = woken[j], woken[j] = 0;
+            ++n_woken;
+        } else {
+            if (is_sleep)
+                expanded[j] = true;
+            ++n_expanded;
+        }
+        if (is_sleep)
+            zz = sleep[j];
+        std::memcpy(Z.data(), T.data(), k * sizeof(uint64_t));
+
+        if (refs::OPT_POR && !is_woken) {
+            /// the thread-local action of the least local state, if any
+            local_state l = L;
+            for (size_t i = 0; i < k; ++i)
+                E[i] = T[i] & X[i];
+            P::for_each(E.data(), lay, k,
+                    [&l](const local_state& _l, const uint64_t&) {
+                        l = _l;
+                        return false;
+                    });
+            const uint64_t b = l < L ? edges_of(shared * L + l, 1) : 0;
+            if (l < L && (zz & b) == 0) {
+                P::dec(Z.data(), lay, l);
+                P::inc(Z.data(), lay, act[l]);
+                const bool is_new = visit(zz & ~b);
+                P::dec(Z.data(), lay, act[l]);
+                P::inc(Z.data(), lay, l);
+                if (is_new) {
+                    ++n_persistent;
+                    continue;
+                }
+            }
+        }
+
+        F.for_each_successor(T.data(), Z.data(), E.data(),
+                [&](const thread_state& src, const size_t& i,
+                        const csr_edge& e) {
+                    if (e.dst == src) /// a self-loop
+                        return;
+                    const size_t v = src.get_id();
+                    const bool is_local = e.dst.get_share() == shared;
+                    /// the bit of a local edge in the sleep sets, if any
+                    const uint64_t b =
+                            is_local && first[v] + i < 64 ?
+                                    uint64_t(1) << (first[v] + i) : 0;
+                    if (is_woken ? (wake & b) == 0 : (zz & b) != 0) {
+                        n_asleep += !is_woken;
+                        return;
+                    }
+                    const uint64_t dep = edges_of(v,
+                            refs::original_TTD.successors(src).size());
+                    visit(is_local ? zz & ~dep : 0);
+                    zz |= b;
+                });
+    }
+
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL) {
+        task.out << "fws with " << PPRINT::plural(n, "thread") << ", " << B
+                << "-bit counters in " << PPRINT::plural(k, "word") << ": ";
+        R.print_stat(task.out) << endl;
+        task.out << "por: " << n_expanded << " states expanded, "
+                << n_persistent << " by a persistent set, "
+                << PPRINT::plural(n_fired, "transition") << " fired, "
+                << n_asleep << " asleep, " << n_woken << " woken" << endl;
+    }
+    return is_reach;
 }
 
 /**
- * @brief This procedure updates the counters of local states.
- * @param Z  : the part of local states
- * @param inc: local state whose counter is incremented
- * @return local states after updating counters
+ * @brief best-first bounded forward search: the states are expanded in the
+ *        order of an A* search towards final, rather than breadth first, so
+ *        that deep witnesses are found without exploring whole layers.
+ *
+ *        Let d(s, l) be the distance to final in the thread-state graph of
+ *        the TTD edges and of the edges <s|l> -> <s'|l> for every change
+ *        from s to s' by an edge of another thread. A thread's own moves,
+ *        the moves of others around it and the spawns it takes part in are
+ *        paths in this graph, so a step brings every thread at most one
+ *        edge closer to final. Final needs m threads, see
+ *        packed_search::n_final, all of which have to get there, so the
+ *        heuristic of a state <s|c> is the m-th least distance d(s, l) of
+ *        its threads, every occupied l counted c(l) times. It never
+ *        overestimates and is consistent. A state with fewer than m threads
+ *        at a finite distance cannot reach final and is not expanded.
+ *
+ *        The spawns are budgeted in search order, so searches with spawns
+ *        stay breadth first.
+ * @param n   : # of initial   threads
+ * @param z   : # of spawn transitions
+ * @param task: its report stream and cancellation flag
+ * @return bool
+ * 		true : if there is a witness path
+ * 		false: otherwise
  */
-map<ushort, ushort> tse::update_counter(const map<ushort, ushort> &Z,
-        const ushort &inc) {
-    auto _Z = Z;   /// local copy of Z
+bool tse::directed_FWS(const uint& n, const uint& z, const fws_task& task) {
+    if (refs::is_exists_SPAWN)
+        return this->standard_FWS(n, z, task);
+    const packed_layout lay(packed_layout::counter_bits(uint64_t(n) + z));
+    switch (lay.bits) {
+    case 4:
+        return this->directed_FWS<4>(n, z, lay, task);
+    case 8:
+        return this->directed_FWS<8>(n, z, lay, task);
+    case 16:
+        return this->directed_FWS<16>(n, z, lay, task);
+    default:
+        return this->directed_FWS<32>(n, z, lay, task);
+    }
+}
 
-    auto iinc = _Z.find(inc);
-    if (iinc != _Z.end()) {
-        iinc->second++;
-    } else {
-        _Z[inc] = 1;
+/**
+ * @brief dispatch the best-first search by the visited set
+ * @param n   : # of initial   threads
+ * @param z   : # of spawn transitions
+ * @param lay : the layout of packed states
+ * @param task: its report stream and cancellation flag
+ * @return bool
+ */
+template<unsigned B>
+bool tse::directed_FWS(const uint& n, const uint& z,
+        const packed_layout& lay, const fws_task& task) {
+    if (refs::OPT_COMPRESS)
+        return this->directed_FWS<B, varint_set<B>>(n, z, lay, task);
+    switch (lay.words) {
+    case 1:
+        return this->directed_FWS<B, packed_set<1>>(n, z, lay, task);
+    case 2:
+        return this->directed_FWS<B, packed_set<2>>(n, z, lay, task);
+    default:
+        return this->directed_FWS<B, packed_set<0>>(n, z, lay, task);
     }
+}
 
-    return _Z;
+/**
+ * @brief the distance of every thread state to final in the thread-state
+ *        graph of directed_FWS, by a backward breadth-first search
+ * @return vector<uint32_t>: by thread state ID, the maximal uint32_t if
+ *         final is unreachable from it
+ */
+static vector<uint32_t> distances_to_final() {
+    const size_t S = thread_state::S, L = thread_state::L;
+    vector<uint32_t> d(S * L, std::numeric_limits<uint32_t>::max());
+    if (refs::FINAL_TS.get_share() >= S || refs::FINAL_TS.get_local() >= L)
+        return d;
+    /// the predecessors of every thread state, and the shared states that
+    /// change to every shared state
+    vector<vector<id_thread_state>> pred(S * L);
+    vector<vector<shared_state>> from(S);
+    vector<bool> is_change(S * S, false);
+    for (size_t v = 0; v < S * L; ++v) {
+        const thread_state src((id_thread_state(v)));
+        const auto& succ = refs::original_TTD.successors(src);
+        for (auto ie = succ.begin(); ie != succ.end(); ++ie) {
+            pred[ie->dst.get_id()].push_back(v);
+            const shared_state& s = src.get_share(), &_s = ie->dst.get_share();
+            if (s != _s && !is_change[s * S + _s]) {
+                is_change[s * S + _s] = true;
+                from[_s].push_back(s);
+            }
+        }
+    }
+    deque<id_thread_state> W;
+    d[refs::FINAL_TS.get_id()] = 0;
+    W.push_back(refs::FINAL_TS.get_id());
+    auto reach = [&](const size_t& u, const uint32_t& du) {
+        if (d[u] == std::numeric_limits<uint32_t>::max()) {
+            d[u] = du;
+            W.push_back(u);
+        }
+    };
+    while (!W.empty()) {
+        const thread_state t(W.front());
+        W.pop_front();
+        const uint32_t du = d[t.get_id()] + 1;
+        const auto& p = pred[t.get_id()];
+        for (auto iv = p.begin(); iv != p.end(); ++iv)
+            reach(*iv, du);
+        const auto& f = from[t.get_share()];
+        for (auto is = f.begin(); is != f.end(); ++is)
+            reach(size_t(*is) * L + t.get_local(), du);
+    }
+    return d;
 }
 
 /**
- * @brief This procedure updates the counters of local states.
- * @param Z  : the part of local states
- * @param dec: local state whose counter is decremented
- * @param inc: local state whose counter is incremented
- * @return local states after updating counters
+ * @brief the best-first search over packed global states with B-bit
+ *        counters, visited in a set of type V. A state is queued by f = g +
+ *        h, ties broken by h and then by discovery; it is visited when it is
+ *        first generated, which keeps the verdict but not the optimality of
+ *        the path, which is not reported anyway.
+ * @param n   : # of initial   threads
+ * @param z   : # of spawn transitions, 0 as searches with spawns are
+ *              breadth first
+ * @param lay : the layout of packed states
+ * @param task: its report stream and cancellation flag
+ * @return bool
  */
-map<ushort, ushort> tse::update_counter(const map<ushort, ushort> &Z,
-        const ushort &dec, const ushort &inc) {
-    if (dec == inc) /// if dec == inc
-        return Z;
+template<unsigned B, typename V>
+bool tse::directed_FWS(const uint& n, const uint& z,
+        const packed_layout& lay, const fws_task& task) {
+    typedef packed<B> P;
+    const size_t L = thread_state::L;
+    const packed_search<B> F(n, lay);
+    V R(lay, refs::OPT_HUGE_PAGES); /// reachable global states
+    const size_t k = R.words();
+    vector<uint64_t> T(k), Z(k), E(k);
 
-    auto _Z = Z;   /// local copy of Z
+    const vector<uint32_t> d = distances_to_final();
+    const uint32_t INF = std::numeric_limits<uint32_t>::max();
+    /// the distances of the occupied local states of a state and their
+    /// counters, if final needs several threads
+    vector<pair<uint32_t, uint64_t>> dc;
+    /// the heuristic of a state
+    auto h = [&](const uint64_t* w) {
+        const size_t v = size_t(P::share(w, lay)) * L;
+        uint32_t m = INF;
+        if (F.n_final == 1) { /// the nearest thread
+            P::for_each(w, lay, k,
+                    [&](const local_state& l, const uint64_t&) {
+                        m = std::min(m, d[v + l]);
+                        return m > 0;
+                    });
+            return m;
+        }
+        dc.clear();
+        P::for_each(w, lay, k, [&](const local_state& l, const uint64_t& c) {
+            dc.emplace_back(d[v + l], c);
+            return true;
+        });
+        std::sort(dc.begin(), dc.end());
+        uint64_t n_near = 0; /// the threads at most as far as the current
+        for (auto ip = dc.begin(); ip != dc.end() && m == INF; ++ip)
+            if ((n_near += ip->second) >= F.n_final)
+                m = ip->first;
+        return m;
+    };
 
-    auto idec = _Z.find(dec);
-    if (idec != _Z.end()) {
-        idec->second--;
-        if (idec->second == 0)
-            _Z.erase(idec);
-    } else {
-        throw ural_rt_err("FWS::update_counter: local state misses");
+    /// the worklist by f << 32 | h, and then by id
+    typedef pair<uint64_t, typename V::id> entry;
+    std::priority_queue<entry, vector<entry>, std::greater<entry>> Q;
+    size_t n_pruned = 0, n_expanded = 0;
+    /// visit the successor Z at distance g from the initial state
+    auto visit = [&](const uint64_t& g) {
+        const auto& ins = R.insert(Z.data());
+        if (!ins.second)
+            return;
+        const uint64_t _h = h(Z.data());
+        if (_h == INF)
+            ++n_pruned;
+        else
+            Q.emplace(((g + _h) << 32) | _h, ins.first);
+    };
+    std::memcpy(Z.data(), F.tau_0.data(), k * sizeof(uint64_t));
+    visit(0);
+
+    bool is_reach = false;
+    while (!Q.empty() && !task.is_cancelled.load(std::memory_order_relaxed)) {
+        const uint64_t key = Q.top().first;
+        R.load(Q.top().second, T.data());
+        Q.pop();
+        ++n_expanded;
+        if (F.is_final(T.data())) {
+            F.report(task.out, T.data());
+            is_reach = true;
+            break;
+        }
+        const uint64_t g = (key >> 32) - (key & 0xffffffffull) + 1;
+        std::memcpy(Z.data(), T.data(), k * sizeof(uint64_t));
+        F.for_each_successor(T.data(), Z.data(), E.data(),
+                [&](const thread_state&, const size_t&, const csr_edge&) {
+                    visit(g);
+                });
     }
 
-    auto iinc = _Z.find(inc);
-    if (iinc != _Z.end()) {
-        iinc->second++;
-    } else {
-        _Z[inc] = 1;
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL) {
+        task.out << "astar with " << PPRINT::plural(n, "thread") << ", " << B
+                << "-bit counters in " << PPRINT::plural(k, "word") << ": ";
+        R.print_stat(task.out) << endl;
+        task.out << "astar: " << n_expanded << " states expanded, "
+                << n_pruned << " pruned, " << Q.size() << " queued" << endl;
+    }
+    return is_reach;
+}
+
+/**
+ * @brief standard_FWS over packed global states with B-bit counters on
+ *        refs::OPT_THREADS workers. The visited states are shared in a
+ *        concurrent_set, and every worker owns a deque of the ids of states
+ *        to expand: it pushes the new successors and pops at its back, and
+ *        steals from the front of the others' when its own runs dry.
+ *
+ *        The search stops as soon as a worker dequeues a state covering
+ *        final, or once no state is queued or being expanded: the latter
+ *        are counted in pending, which a new state increments before its
+ *        parent decrements it, so it only drops to 0 at the end.
+ *
+ *        Only searches without spawns are parallel, see is_parallel_FWS.
+ * @param n   : # of initial   threads
+ * @param z   : # of spawn transitions, unused as there is no spawn
+ * @param lay : the layout of packed states
+ * @param task: its report stream and cancellation flag
+ * @return bool
+ */
+template<unsigned B>
+bool tse::parallel_FWS(const uint& n, const uint& z, const packed_layout& lay,
+        const fws_task& task) {
+    const auto start = std::chrono::steady_clock::now();
+    const size_t k = lay.words, n_workers = refs::OPT_THREADS;
+    concurrent_set R(k);                   /// reachable global states
+    vector<std::unique_ptr<work_deque>> D; /// the deques of workers
+    for (size_t i = 0; i < n_workers; ++i)
+        D.emplace_back(new work_deque());
+
+    const packed_search<B> F(n, lay);
+    std::atomic<bool> is_stop(false);  /// final is covered or a worker failed
+    std::atomic<bool> is_reach(false);
+    std::atomic<size_t> pending(1);    /// states queued or being expanded
+    vector<uint64_t> cover(k);         /// the covering state, once is_reach
+    vector<size_t> expanded(n_workers, 0), stolen(n_workers, 0);
+
+    {
+        concurrent_set::handle H(R);
+        const uint64_t i_0 = H.insert(F.tau_0.data()).first;
+        D[0]->push(i_0);
+    }
+    auto search = [&](const size_t& id) {
+        concurrent_set::handle H(R);
+        work_deque& own = *D[id];
+        /// the expanded state, the scratch state on which successors are
+        /// generated in place and the enabled sources
+        vector<uint64_t> T(k), Z(k), E(k);
+        uint64_t i_T;
+        backoff idle; /// while there is nothing to steal
+        while (!is_stop.load(std::memory_order_relaxed)
+                && !task.is_cancelled.load(std::memory_order_relaxed)) {
+            if (!own.pop(i_T)) {
+                bool is_stolen = false;
+                for (size_t i = 1; i < n_workers && !is_stolen; ++i)
+                    is_stolen = D[(id + i) % n_workers]->steal(i_T);
+                if (!is_stolen) {
+                    if (pending.load() == 0)
+                        break;
+                    idle.pause();
+                    continue;
+                }
+                ++stolen[id];
+            }
+            idle.reset();
+            ++expanded[id];
+            std::memcpy(T.data(), R[i_T], k * sizeof(uint64_t));
+
+            if (F.is_final(T.data())) {
+                if (!is_reach.exchange(true))
+                    cover = T;
+                is_stop = true;
+                break;
+            }
+            std::memcpy(Z.data(), T.data(), k * sizeof(uint64_t));
+            F.for_each_successor(T.data(), Z.data(), E.data(),
+                    [&](const thread_state&, const size_t&, const csr_edge&) {
+                        const auto& ins = H.insert(Z.data());
+                        if (ins.second) {
+                            pending.fetch_add(1);
+                            own.push(ins.first);
+                        }
+                    });
+            pending.fetch_sub(1);
+        }
+    };
+
+    {
+        vector<std::unique_ptr<worker>> pool;
+        for (size_t i = 1; i < n_workers; ++i)
+            pool.emplace_back(new worker([&, i]() {
+                try {
+                    search(i);
+                } catch (...) {
+                    is_stop = true;
+                    throw;
+                }
+            }));
+        try {
+            search(0);
+        } catch (...) {
+            is_stop = true;
+            throw; /// the pool joins the others on unwinding
+        }
+        for (auto iw = pool.begin(); iw != pool.end(); ++iw)
+            (*iw)->join();
+    }
+
+    if (is_reach)
+        F.report(task.out, cover.data());
+
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL) {
+        const double seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+        size_t n_stolen = 0;
+        for (auto is = stolen.begin(); is != stolen.end(); ++is)
+            n_stolen += *is;
+        task.out << "fws with " << PPRINT::plural(n, "thread") << " on "
+                << PPRINT::plural(n_workers, "worker") << ", " << B
+                << "-bit counters in " << PPRINT::plural(k, "word") << ": ";
+        R.print_stat(task.out) << endl;
+        task.out << "workers: " << seconds << " s, "
+                << *std::min_element(expanded.begin(), expanded.end())
+                << " (min) "
+                << *std::max_element(expanded.begin(), expanded.end())
+                << " (max) states expanded, " << n_stolen << " stolen"
+                << endl;
+    }
+    return is_reach;
+}
+
+/**
+ * @brief standard_FWS over global states whose counters are Locals
+ * @param n: # of initial   threads
+ * @param z: # of spawn transitions
+ * @param task: its report stream and cancellation flag
+ * @return bool
+ */
+bool tse::counter_FWS(const uint& n, const uint& z, const fws_task& task) {
+    auto spw = z;
+//	cout << "fws: " << n << "               " << z << endl;
+    const global_state tau_0(refs::INITL_TS, n); /// start from the initial state with n threads
+    visited_set R(refs::OPT_HUGE_PAGES); /// reachable global states
+    ring_queue<visited_set::id> W; /// worklist
+    W.push(R.insert(tau_0.get_share(), tau_0.get_locals(),
+            zobrist::hash(tau_0.get_share(), tau_0.get_locals())).first);
+    /// successors are generated in place: fire a transition on Z, probe
+    /// R, and undo it. Only new states are copied into R. The expanded
+    /// state is decoded into T, so neither allocates once warmed up.
+    shared_state shared;
+    Locals T, Z;
+    bool is_reach = false;
+    while (!W.empty() && !task.is_cancelled.load(std::memory_order_relaxed)) {
+        R.load(W.front(), shared, T);
+        const uint64_t h = R.hash(W.front()) ^ zobrist::share(shared);
+        W.pop();
+        if (shared == refs::FINAL_TS.get_share()
+                && T.get(refs::FINAL_TS.get_local())
+                        >= refs::TARGET_THR_NUM) {
+            task.out << refs::FINAL_TS << endl;
+            task.out << "covering configuration: " << global_state(shared, T)
+                    << endl;
+            // this->reproduce_witness_path(tau.pi);
+            is_reach = true;
+            break;
+        }
+        Z = T;
+        for (auto il = T.begin(); il != T.end(); ++il) {
+            thread_state src(shared, il->first);
+            if (!refs::original_TTD.is_source(src)) /// a dead local state
+                continue;
+            const auto& succ = refs::original_TTD.successors(src);
+            for (auto ie = succ.begin(); ie != succ.end(); ++ie) {
+                const local_state& dec = src.get_local();
+                const local_state& inc = ie->dst.get_local();
+                /// the hash of the successor, derived from tau's
+                uint64_t _h = h ^ zobrist::share(ie->dst.get_share());
+                pair<visited_set::id, bool> ins;
+                if (ie->is_spawn) { /// if src +> dst true
+                    if (spw > 0) {
+                        spw--;
+                        _h ^= zobrist::spawn(inc, Z.get(inc));
+                        Z.inc(inc);
+                        ins = R.insert(ie->dst.get_share(), Z, _h);
+                        Z.dec(inc);
+                    } else { /// if the we already spawn z times, we can't
+                        continue; /// spawn any more and have to skip src +> dst;
+                    }
+                } else {
+                    if (dec != inc)
+                        _h ^= zobrist::move(dec, il->second, inc,
+                                Z.get(inc));
+                    Z.move(dec, inc);
+                    ins = R.insert(ie->dst.get_share(), Z, _h);
+                    Z.move(inc, dec);
+                }
+                if (ins.second) {
+                    /// record _tau's predecessor tau: for witness
+                    //_tau.pi = std::make_shared<Global_State>(tau);
+                    W.push(ins.first);
+                }
+            }
+        }
     }
 
-    return _Z;
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL) {
+        task.out << "fws with " << PPRINT::plural(n, "thread") << ": ";
+        R.print_stat(task.out) << endl;
+    }
+    return is_reach;
 }
 
 /**
- * @brief determine if (src, dst) correspßonds to a spawn transition
- * @param src
- * @param dst
- * @param spawn_trans
+ * @brief symbolic bounded forward search: the reachable global states are
+ *        computed as an MDD by saturation, and then searched for one that
+ *        covers final. The variables are, from the bottom level up, the
+ *        shared state, the counters of local states 0 ... L - 1, and, if
+ *        there are spawn transitions, the number of spawns left. Every
+ *        transition is an event whose top level is its highest counter, so
+ *        most events are local to the lower part of the diagram.
+ *
+ *        The spawn budget z is per path here, not per search as in
+ *        standard_FWS, so it finds every witness that standard_FWS finds.
+ * @param n: # of initial   threads
+ * @param z: # of spawn transitions
+ * @param task: its report stream and cancellation flag
  * @return bool
- * 			true : src +> dst
- * 			false: otherwise
+ * 		true : if there is a witness path
+ * 		false: otherwise
  */
-bool tse::is_spawn_transition(const thread_state& src,
-        const thread_state& dst) {
-    auto ifind = refs::spawntra_TTD.find(src);
-    if (ifind == refs::spawntra_TTD.end()) {
+bool tse::symbolic_FWS(const uint& n, const uint& z, const fws_task& task) {
+    if (uint64_t(n) + z >= std::numeric_limits<uint32_t>::max())
+        throw ural_rt_err("symbolic_FWS: too many threads");
+    const uint32_t N = n + z; /// the maximum number of threads
+    const uint32_t L = thread_state::L;
+    const uint32_t share_lv = 1, budget_lv = L + 2;
+    auto local_lv = [](const local_state& l) {return uint32_t(l) + 2;};
+
+    vector<uint32_t> domains(L + 2, N + 1);
+    domains[share_lv] = thread_state::S;
+    if (refs::is_exists_SPAWN)
+        domains.push_back(z + 1);
+    mdd_forest F(domains);
+
+    mdd_saturation sat(F);
+    for (size_t v = 0; v < refs::original_TTD.size(); ++v) {
+        const thread_state src((id_thread_state(v)));
+        const auto& succ = refs::original_TTD.successors(src);
+        for (auto ie = succ.begin(); ie != succ.end(); ++ie) {
+            const shared_state &s = src.get_share(), &_s = ie->dst.get_share();
+            const local_state &l = src.get_local(), &_l = ie->dst.get_local();
+            vector<mdd_local> event;
+            event.push_back(
+                    mdd_local { share_lv, s, s, int32_t(_s) - int32_t(s) });
+            if (ie->is_spawn) { /// src stays, a new thread starts in _l
+                if (z == 0)
+                    continue;
+                event.push_back(mdd_local { budget_lv, 1, z, -1 });
+                if (l == _l) {
+                    event.push_back(mdd_local { local_lv(l), 1, N - 1, 1 });
+                } else {
+                    event.push_back(mdd_local { local_lv(l), 1, N, 0 });
+                    event.push_back(mdd_local { local_lv(_l), 0, N - 1, 1 });
+                }
+            } else if (l == _l) {
+                if (s == _s) /// a self-loop changes nothing
+                    continue;
+                event.push_back(mdd_local { local_lv(l), 1, N, 0 });
+            } else {
+                event.push_back(mdd_local { local_lv(l), 1, N, -1 });
+                event.push_back(mdd_local { local_lv(_l), 0, N - 1, 1 });
+            }
+            sat.add(std::move(event));
+        }
+    }
+
+    /// saturation runs to its fixpoint: a cancelled search stops only here
+    if (task.is_cancelled.load(std::memory_order_relaxed))
         return false;
-    } else {
-        auto ifnd = std::find(ifind->second.begin(), ifind->second.end(), dst);
-        if (ifnd == ifind->second.end())
-            return false;
-        else
-            return true;
+
+    /// the initial state with n threads and z spawns left
+    vector<uint32_t> values(F.levels() + 1, 0);
+    values[share_lv] = refs::INITL_TS.get_share();
+    values[local_lv(refs::INITL_TS.get_local())] = n;
+    if (refs::is_exists_SPAWN)
+        values[budget_lv] = z;
+    const mdd_forest::node R = sat.saturate(F.path(values));
+
+    /// pick a reachable state covering final
+    vector<pair<uint32_t, uint32_t>> ranges(F.levels() + 1);
+    for (uint32_t k = 1; k <= F.levels(); ++k)
+        ranges[k] = std::make_pair(0, F.domain(k) - 1);
+    ranges[share_lv] = std::make_pair(refs::FINAL_TS.get_share(),
+            refs::FINAL_TS.get_share());
+    ranges[local_lv(refs::FINAL_TS.get_local())].first =
+            refs::TARGET_THR_NUM;
+    const bool is_reach = F.pick(R, ranges, values);
+    if (is_reach) {
+        task.out << refs::FINAL_TS << endl;
+        task.out << "covering configuration: <" << values[share_lv] << "|";
+        for (uint32_t l = 0; l < L; ++l)
+            if (values[local_lv(l)] > 0)
+                task.out << "(" << l << "," << values[local_lv(l)] << ")";
+        task.out << ">" << endl;
+    }
+
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL) {
+        task.out << "mdd with " << PPRINT::plural(n, "thread") << ": "
+                << F.count(R) << " reachable states in " << F.size(R)
+                << " nodes, " << F.size() << " nodes at peak, "
+                << PPRINT::plural(sat.size(), "event") << endl;
     }
+    return is_reach;
 }
 
 } /* namespace sura */
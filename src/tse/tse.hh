@@ -12,26 +12,56 @@
 
 #include "../util/heads.hh"
 #include "../util/refs.hh"
+#include "../util/ttdb.hh"
+#include "../util/incidence.hh"
+#include "../util/packed.hh"
+#include "../util/mdd.hh"
+#include "../util/concurrency.hh"
+#include "../util/concurrent_set.hh"
+
+#include "km.hh"
+#include "bws.hh"
 
 using namespace z3;
 
 namespace sura {
-/// Aliasing the pair of incoming & outgoing transitions
-using inout = pair<deque<id_tran>, deque<id_tran>>;
-
 /// Aliasing vector<expr> as vec_expr
 using vec_expr = vector<expr>;
 
+/// a batch of consecutive transitions x_first, x_first + 1, ..., handed
+/// from the reader stage to the encoder stage
+struct tran_batch {
+    id_tran first;
+    vector<ttdb_tran> trans;
+};
+
+/// the variables of the transitions entering and leaving every state: the
+/// rows of an incidence matrix as terms of the thread-state equation
+struct eq_rows {
+    vector<expr_vector> in;
+    vector<expr_vector> out;
+};
+
+/// the report stream and the cancellation flag of one search with fixed
+/// threads; several such searches may run at once
+struct fws_task {
+    ostream& out;
+    const std::atomic<bool>& is_cancelled;
+};
+
 enum class result {
     reach = 0, unreach = 1, unknown = 2
 };
 
 class tse {
 public:
+    tse();
     tse(const id_tran &size_R, const deque<id_tran>& spawns);
     ~tse();
-    bool reachability_analysis_via_tse(const vector<inout>& l_in_out,
-            const vector<inout>& s_in_out);
+    bool reachability_analysis_via_tse(const incidence& l_matrix,
+            const incidence& s_matrix);
+    bool reachability_analysis_via_tse();
+    void encode(const tran_batch& batch);
 private:
     /// All expressions, func_decl, etc., appearing in the class must be
     /// defined in same context; otherwise, segmentation fault happens
@@ -39,8 +69,10 @@ private:
 
     expr n_0; /// counter variable for initial local state
 
-    string x_affix; /// prefix for marking equation variables
-    uint x_index;   /// index for marking equation variables
+    string x_affix;  /// prefix for marking equation variables
+    vec_expr x_vars; /// the variable of every transition, by transition ID
+    eq_rows l_rows; /// the rows of local  states encoded via encode
+    eq_rows s_rows; /// the rows of shared states encoded via encode
 
     expr sum_z; /// expression of summarizing fired spawns
     uint max_n;  /// maximal number of initial   threads
@@ -48,23 +80,56 @@ private:
 
     solver s_solver; /// define a global solver
 
-    result solicit_for_TSE(const vector<inout>& l_in_out,
-            const vector<inout>& s_in_out);
-    vec_expr build_CL(const vector<inout>& l_in_out);
-    vec_expr build_CS(const vector<inout>& s_in_out);
+    /// the reachable states of the last complete explicit search without
+    /// spawns and its number of initial threads, 0 if there is none
+    sparse_states fws_states;
+    uint fws_n;
+    /// whether a CEGAR round can follow the current search, which then
+    /// keeps its states for it
+    bool is_refinable;
+
+    eq_rows rows_of(const incidence& matrix);
+    expr sum_of(const expr_vector& terms, const expr& c);
+    result solicit_for_TSE();
+    vec_expr build_CL(const eq_rows& l_rows);
+    vec_expr build_CS(const eq_rows& s_rows);
 
     result check_sat_via_smt_solver();
     void parse_sat_solution(const model& m);
     uint get_z3_const_uint(const expr& e);
 
+    /// the explicit search packs states of at most these many words
+    static const size_t PACKED_MAX_WORDS;
+
     bool solicit_for_CEGAR();
     bool check_reach_with_fixed_threads(const uint& n, const uint& z);
-    bool standard_FWS(const uint& n, const uint& z);
-    map<ushort, ushort> update_counter(const map<ushort, ushort> &Z,
-            const ushort &inc);
-    map<ushort, ushort> update_counter(const map<ushort, ushort> &Z,
-            const ushort &dec, const ushort &inc);
-    bool is_spawn_transition(const thread_state& src, const thread_state& dst);
+    bool parallel_explore(const uint& n, const uint& z);
+    bool explore(const uint& n, const uint& z, const fws_task& task);
+    bool standard_FWS(const uint& n, const uint& z, const fws_task& task);
+    bool symbolic_FWS(const uint& n, const uint& z, const fws_task& task);
+    bool directed_FWS(const uint& n, const uint& z, const fws_task& task);
+    template<unsigned B>
+    bool directed_FWS(const uint& n, const uint& z, const packed_layout& lay,
+            const fws_task& task);
+    template<unsigned B, typename V>
+    bool directed_FWS(const uint& n, const uint& z, const packed_layout& lay,
+            const fws_task& task);
+    bool counter_FWS(const uint& n, const uint& z, const fws_task& task);
+    template<unsigned B, typename V>
+    bool packed_FWS(const uint& n, const uint& z, const packed_layout& lay,
+            const fws_task& task);
+    template<unsigned B>
+    bool packed_FWS(const uint& n, const uint& z, const packed_layout& lay,
+            const fws_task& task);
+    template<unsigned B, typename V>
+    bool reduced_FWS(const uint& n, const uint& z, const packed_layout& lay,
+            const fws_task& task);
+    template<unsigned B>
+    bool antichain_FWS(const uint& n, const uint& z, const packed_layout& lay,
+            const fws_task& task);
+    template<unsigned B>
+    bool parallel_FWS(const uint& n, const uint& z, const packed_layout& lay,
+            const fws_task& task);
 };
 
 } /* namespace sura */
@@ -9,6 +9,154 @@
 
 namespace sura {
 
+/// inputs of at least this many bytes are parsed in parallel
+const size_t ttd_text::PARALLEL_PARSE_SIZE = 8 * 1024 * 1024;
+/// the maximal number of decompressed blocks in flight
+const size_t ttd_text::QUEUE_DEPTH = 4;
+
+/**
+ * @brief constructor: detect the compression format and parse the header.
+ *        Compressed inputs are decompressed by a background thread from
+ *        here on, so the input is never fully decompressed in memory.
+ * @param in: the mapped input file
+ */
+ttd_text::ttd_text(const mapped_file& in) :
+        in(in), format(zstream::detect(in.begin(), in.end())), first(
+                nullptr), blocks(QUEUE_DEPTH), pending(), is_eof(false), n_bytes(
+                0), inflater() {
+    if (format == zstream::PLAIN) {
+        first = parser::parse_ttd_header(in.begin(), in.end());
+        return;
+    }
+
+    inflater.reset(new worker([this]() {
+        try {
+            zstream::decompress(format, this->in.begin(), this->in.end(),
+                    blocks);
+        } catch (...) {
+            blocks.close();
+            throw;
+        }
+        blocks.close();
+    }));
+
+    try {
+        const char* p = nullptr;
+        while (p == nullptr) {
+            is_eof = !this->next_block();
+            const size_t cut = is_eof ? pending.size() : pending.rfind('\n') + 1;
+            p = parser::parse_ttd_header(pending.data(), pending.data() + cut,
+                    !is_eof);
+        }
+        pending.erase(0, p - pending.data());
+    } catch (...) {
+        blocks.close(); /// stop the decompressor
+        throw;
+    }
+}
+
+ttd_text::~ttd_text() {
+    blocks.close(); /// the inflater joins right after
+}
+
+/**
+ * @brief append the next decompressed block to pending
+ * @return bool
+ *         true : if a block is appended
+ *         false: if the input is exhausted
+ */
+bool ttd_text::next_block() {
+    string block;
+    if (!blocks.pop(block)) {
+        inflater->join(); /// rethrow decompression errors
+        return false;
+    }
+    n_bytes += block.size();
+    if (pending.empty())
+        pending.swap(block);
+    else
+        pending.append(block);
+    return true;
+}
+
+/**
+ * @brief parse all transitions after the header
+ * @param emit: callback emit(src, dst, is_spawn) for every transition
+ */
+template<typename F>
+void ttd_text::parse(F emit) {
+    if (format == zstream::PLAIN)
+        this->parse_mapped(emit);
+    else
+        this->parse_stream(emit);
+}
+
+/**
+ * @brief parse the transitions of a plain-text .ttd file in place: comments
+ *        are skipped on the fly, so there is no intermediate copy. Large
+ *        inputs are split into chunks parsed on all cores; the callback
+ *        still sees the transitions in file order.
+ * @param emit: callback emit(src, dst, is_spawn) for every transition
+ */
+template<typename F>
+void ttd_text::parse_mapped(F emit) {
+    const auto start = std::chrono::steady_clock::now();
+
+    uint n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (size_t(in.end() - first) < PARALLEL_PARSE_SIZE)
+        n_threads = 1;
+    if (n_threads > 1)
+        parser::parse_ttd_parallel(first, in.end(), n_threads, emit);
+    else
+        parser::parse_ttd(first, in.end(), emit);
+
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL) {
+        const double seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+        const double mb = in.size() / (1024.0 * 1024.0);
+        cout << "parse: " << mb << " MB in " << seconds << " s ("
+                << (seconds > 0 ? mb / seconds : 0) << " MB/s, "
+                << PPRINT::plural(n_threads, "thread") << ")" << endl;
+    }
+}
+
+/**
+ * @brief parse the transitions of a compressed .ttd file block by block
+ *        while it is decompressed. Only the text up to the last complete
+ *        line is parsed; the rest is carried over to the next block.
+ * @param emit: callback emit(src, dst, is_spawn) for every transition
+ */
+template<typename F>
+void ttd_text::parse_stream(F emit) {
+    const auto start = std::chrono::steady_clock::now();
+
+    while (true) {
+        const size_t cut = is_eof ? pending.size() : pending.rfind('\n') + 1;
+        const char* p = parser::parse_ttd(pending.data(),
+                pending.data() + cut, emit, !is_eof);
+        pending.erase(0, p - pending.data());
+        if (is_eof)
+            break;
+        is_eof = !this->next_block();
+    }
+
+    if (refs::OPT_PRINT_STAT || refs::OPT_PRINT_ALL) {
+        const double seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+        const double mb = n_bytes / (1024.0 * 1024.0);
+        cout << "parse: " << mb << " MB " << zstream::name(format)
+                << "-decompressed in " << seconds << " s ("
+                << (seconds > 0 ? mb / seconds : 0) << " MB/s, "
+                << in.size() / (1024.0 * 1024.0) << " MB compressed)"
+                << endl;
+    }
+}
+
+/// the number of transitions per batch handed to the encoder
+const size_t ura::BATCH_SIZE = 64 * 1024;
+/// the maximal number of batches in flight between reader and encoder
+const size_t ura::PIPELINE_DEPTH = 8;
+
 ura::ura() {
 }
 
@@ -62,111 +210,235 @@ bool ura::reachability_analysis_via_tse(const string& filename,
     if (filename == "X") { // make random structure
         throw ural_rt_err("Please assign the input file!");
     } else {
-        /// original input file before removing comments
-        ifstream org_in(filename.c_str());
-        if (!org_in.good())
-            throw ural_rt_err("Input file does not find!");
-        parser::remove_comments(org_in, "/tmp/tmp.ttd.no_comment", "#");
-        org_in.close();
-
-        /// new input file after removing comments
-        ifstream new_in("/tmp/tmp.ttd.no_comment");
-
-        new_in >> thread_state::S >> thread_state::L;
-
-        /// store all incoming & outgoing transitions from same local state
-        /// key is the shared state,
-        ///        first  value is the set of incoming transition id
-        ///        second value is the set of outgoing transition id
-        vector<inout> l_in_out(thread_state::L);
-
-        /// store all incoming & outgoing transitions from same shared state
-        /// key is the shared state,
-        ///        first  value is the set of incoming transition id
-        ///        second value is the set of outgoing transition id
-        vector<inout> s_in_out(thread_state::S);
-
-        id_tran transition_ID = 0;  /// define unique transition ID
-        deque<id_tran> spawn_vars;
-
-        shared_state s1, s2;              /// shared states
-        local_state l1, l2;               /// local  states
-        string sep;                       /// separator
-        while (new_in >> s1 >> l1 >> sep >> s2 >> l2) {
-            DBG_STD(
-                    cout << s1 << " " << l1 << " -> " << s2 << " " << l2 << " "
-                    << transition_ID << "\n")
-            if (!is_self_loop && s1 == s2 && l1 == l2) /// remove self loops
-                continue;
-
-            if (sep == "->" || sep == "+>") {
-                const thread_state src_TS(s1, l1);
-                const thread_state dst_TS(s2, l2);
-
-                l_in_out[l1].second.emplace_back(transition_ID);
-                l_in_out[l2].first.emplace_back(transition_ID);
-
-                if (s1 != s2) {
-                    s_in_out[s1].second.emplace_back(transition_ID);
-                    s_in_out[s2].first.emplace_back(transition_ID);
-                }
+        /// the format is detected by the magic header: a compiled .ttdb
+        /// file or a plain-text .ttd file
+        const mapped_file in(filename);
+        if (ttdb::is_ttdb(in.begin(), in.end()))
+            return this->reachability_analysis_via_ttdb(
+                    ttdb(in.begin(), in.end()), is_self_loop);
+        return this->reachability_analysis_via_ttd(in, is_self_loop);
+    }
+}
 
-                if (sep == "+>") {
-                    if (!refs::is_exists_SPAWN)
-                        refs::is_exists_SPAWN = true;
-                    refs::spawntra_TTD[src_TS].emplace_back(dst_TS);
-                    spawn_vars.emplace_back(transition_ID);
-                }
-                refs::original_TTD[src_TS].emplace_back(dst_TS);
+/**
+ * @brief analyze a plain-text .ttd file, possibly compressed. Parsing and
+ *        encoding are pipelined: a reader thread parses the input and hands
+ *        batches of transitions to the encoder, which creates their
+ *        variables and adds them to the rows of the equation as the batch
+ *        arrives. Only C_L and C_S, which need complete rows, are built
+ *        after the last batch.
+ * @param in          : the mapped input file
+ * @param is_self_loop: whether to keep self-loops
+ */
+bool ura::reachability_analysis_via_ttd(const mapped_file& in,
+        const bool& is_self_loop) {
+    ttd_text text(in);
 
-                transition_ID++; /// increment unique transition ID
-            } else {
-                throw ural_rt_err("illegal transition");
-            }
+    tse t;
+    blocking_queue<tran_batch> batches(PIPELINE_DEPTH);
+    worker reader([&]() {
+        try {
+            this->read_ttd(text, is_self_loop, batches);
+        } catch (...) {
+            batches.close();
+            throw;
         }
-        new_in.close();
+        batches.close();
+    });
+
+    try {
+        tran_batch batch;
+        /// stop early if the reader fails, its error is rethrown below
+        while (!reader.failed() && batches.pop(batch))
+            t.encode(batch);
+    } catch (...) {
+        batches.close(); /// stop the reader
+        throw;
+    }
+    reader.join();
+
+    if (refs::OPT_PRINT_ADJ || refs::OPT_PRINT_ALL) {
+        cout << "The original TTD:" << endl;
+        util::print_adj_list(refs::original_TTD);
+        cout << endl;
+    }
+
+    return t.reachability_analysis_via_tse();
+}
+
+/**
+ * @brief analyze a compiled .ttdb file
+ * @param db          : the mapped .ttdb file
+ * @param is_self_loop: whether to keep self-loops
+ */
+bool ura::reachability_analysis_via_ttdb(const ttdb& db,
+        const bool& is_self_loop) {
+    /// the incidence matrices of local and shared states: their rows list
+    /// the incoming & outgoing transition IDs of every state
+    incidence l_matrix, s_matrix;
+    deque<id_tran> spawn_vars;
+    const id_tran& transition_ID = this->load_ttdb(db, is_self_loop, l_matrix,
+            s_matrix, spawn_vars);
 
 #ifndef NDEBUG
-        cout << __func__ << "\n";
-        cout << "Initial Thread State " << refs::INITL_TS << "\t";
-        cout << "Final Thread State " << refs::FINAL_TS << "\n";
-
-        for (size_t is = 0; is < l_in_out.size(); ++is) {
-            cout << "local state: " << is << " ";
-            for (auto iv = l_in_out[is].first.begin();
-                    iv != l_in_out[is].first.end(); ++iv)
-            cout << "x" << *iv
-            << (std::next(iv) != l_in_out[is].first.end() ?
-                    " + " : "");
-            for (auto iv = l_in_out[is].second.begin();
-                    iv != l_in_out[is].second.end(); ++iv)
-            cout << " - " << "x" << *iv;
-            cout << "\n";
-        }
+    cout << __func__ << "\n";
+    cout << "Initial Thread State " << refs::INITL_TS << "\t";
+    cout << "Final Thread State " << refs::FINAL_TS << "\n";
 
-        for (size_t is = 0; is < s_in_out.size(); ++is) {
-            cout << "shared state: " << is << " ";
-            for (auto iv = s_in_out[is].first.begin();
-                    iv != s_in_out[is].first.end(); ++iv)
-            cout << "x" << *iv
-            << " + ";
-            for (auto iv = s_in_out[is].second.begin();
-                    iv != s_in_out[is].second.end(); ++iv)
-            cout << " - " << "x" << *iv;
-            cout << "\n";
-        }
-        DBG_LOC();
-#endif
+    for (size_t is = 0; is < l_matrix.rows(); ++is) {
+        cout << "local state: " << is << " ";
+        const auto& in = l_matrix.in(is);
+        for (auto iv = in.begin(); iv != in.end(); ++iv)
+        cout << "x" << *iv << (std::next(iv) != in.end() ? " + " : "");
+        const auto& out = l_matrix.out(is);
+        for (auto iv = out.begin(); iv != out.end(); ++iv)
+        cout << " - " << "x" << *iv;
+        cout << "\n";
+    }
 
-        if (refs::OPT_PRINT_ADJ || refs::OPT_PRINT_ALL) {
-            cout << "The original TTD:" << endl;
-            util::print_adj_list(refs::original_TTD);
-            cout << endl;
-        }
+    for (size_t is = 0; is < s_matrix.rows(); ++is) {
+        cout << "shared state: " << is << " ";
+        const auto& in = s_matrix.in(is);
+        for (auto iv = in.begin(); iv != in.end(); ++iv)
+        cout << "x" << *iv << " + ";
+        const auto& out = s_matrix.out(is);
+        for (auto iv = out.begin(); iv != out.end(); ++iv)
+        cout << " - " << "x" << *iv;
+        cout << "\n";
+    }
+    DBG_LOC();
+#endif
 
-        tse t(transition_ID, spawn_vars);
-        return t.reachability_analysis_via_tse(l_in_out, s_in_out);
+    if (refs::OPT_PRINT_ADJ || refs::OPT_PRINT_ALL) {
+        cout << "The original TTD:" << endl;
+        util::print_adj_list(refs::original_TTD);
+        cout << endl;
     }
+
+    tse t(transition_ID, spawn_vars);
+    return t.reachability_analysis_via_tse(l_matrix, s_matrix);
+}
+
+/**
+ * @brief the reader stage of the pipeline: parse the transitions, remove
+ *        self-loops, build the adjacency lists and hand the transitions to
+ *        the encoder in batches of BATCH_SIZE
+ * @param text        : the input after its header
+ * @param is_self_loop: whether to keep self-loops
+ * @param batches     : the queue to the encoder
+ */
+void ura::read_ttd(ttd_text& text, const bool& is_self_loop,
+        blocking_queue<tran_batch>& batches) {
+    id_tran transition_ID = 0;  /// define unique transition ID
+    tran_batch batch { transition_ID, vector<ttdb_tran>() };
+    batch.trans.reserve(BATCH_SIZE);
+    text.parse(
+            [&](const thread_state& src_TS, const thread_state& dst_TS,
+                    const bool& is_spawn) {
+                DBG_STD(
+                        cout << src_TS << " -> " << dst_TS << " "
+                        << transition_ID << "\n")
+                if (!is_self_loop && src_TS == dst_TS) /// remove self loops
+                    return;
+
+                if (is_spawn && !refs::is_exists_SPAWN)
+                    refs::is_exists_SPAWN = true;
+                refs::original_TTD.add(src_TS, dst_TS, is_spawn);
+
+                batch.trans.emplace_back(ttdb_tran { src_TS.get_share(),
+                                src_TS.get_local(), dst_TS.get_share(),
+                                dst_TS.get_local(),
+                                is_spawn ? ttdb_tran::SPAWN : 0u });
+                transition_ID++; /// increment unique transition ID
+
+                if (batch.trans.size() == BATCH_SIZE) {
+                    if (!batches.push(std::move(batch)))
+                        throw ural_rt_err("read_ttd: the encoder stopped");
+                    batch = tran_batch { transition_ID, vector<ttdb_tran>() };
+                    batch.trans.reserve(BATCH_SIZE);
+                }
+            });
+    if (!batch.trans.empty())
+        batches.push(std::move(batch));
+    refs::original_TTD.build();
+}
+
+/**
+ * @brief load a compiled .ttdb file: the incidence matrices are
+ *        precomputed, so they are viewed in the mapped file without copying
+ * @param db          : the mapped .ttdb file
+ * @param is_self_loop: whether to keep self-loops
+ * @param l_matrix    : the incidence matrix of local  states
+ * @param s_matrix    : the incidence matrix of shared states
+ * @param spawn_vars  : IDs of spawn transitions
+ * @return the number of transitions
+ */
+id_tran ura::load_ttdb(const ttdb& db, const bool& is_self_loop,
+        incidence& l_matrix, incidence& s_matrix, deque<id_tran>& spawn_vars) {
+    if (db.is_self_loop() != is_self_loop)
+        throw ural_rt_err(
+                string("load_ttdb: the input is compiled ")
+                        + (db.is_self_loop() ? "with" : "without")
+                        + " --self-loop, please recompile it");
+    if (db.get_S() > std::numeric_limits<size_s>::max()
+            || db.get_L() > std::numeric_limits<size_l>::max())
+        throw ural_rt_err("load_ttdb: the number of states exceeds the limit");
+    thread_state::S = db.get_S();
+    thread_state::L = db.get_L();
+
+    const auto& trans = db.get_trans();
+    for (auto it = trans.begin(); it != trans.end(); ++it)
+        if (it->s1 >= thread_state::S || it->s2 >= thread_state::S
+                || it->l1 >= thread_state::L || it->l2 >= thread_state::L)
+            throw ural_rt_err("load_ttdb: thread state out of range");
+    refs::original_TTD.build(trans);
+    refs::is_exists_SPAWN = db.is_exists_spawn();
+
+    /// the spawn IDs index x_vars in the encoder: each of them has to name
+    /// a spawn transition, and every spawn transition has to be named
+    const auto& spawns = db.get_ids(ttdb::SPAWN_IDS);
+    size_t n_spawns = 0;
+    for (auto it = trans.begin(); it != trans.end(); ++it)
+        if (it->flags & ttdb_tran::SPAWN)
+            ++n_spawns;
+    if (spawns.size() != n_spawns || (n_spawns > 0) != db.is_exists_spawn())
+        throw ural_rt_err("load_ttdb: inconsistent spawn transitions");
+    for (auto it = spawns.begin(); it != spawns.end(); ++it)
+        if (*it >= trans.size() || !(trans[*it].flags & ttdb_tran::SPAWN))
+            throw ural_rt_err("load_ttdb: spawn transition ID out of range");
+    spawn_vars.assign(spawns.begin(), spawns.end());
+
+    l_matrix = incidence(db, ttdb::L_IN_OFF, ttdb::L_OUT_OFF);
+    s_matrix = incidence(db, ttdb::S_IN_OFF, ttdb::S_OUT_OFF);
+    return trans.size();
+}
+
+/**
+ * @brief compile a plain-text .ttd file, possibly compressed, into the
+ *        binary .ttdb format
+ * @param filename    : the name of input  .ttd  file
+ * @param output      : the name of output .ttdb file
+ * @param is_self_loop: whether to keep self-loops
+ */
+void ura::compile_ttd(const string& filename, const string& output,
+        const bool& is_self_loop) {
+    const mapped_file in(filename);
+    if (ttdb::is_ttdb(in.begin(), in.end()))
+        throw ural_rt_err("compile_ttd: the input is compiled already");
+    ttd_text text(in);
+
+    vector<ttdb_tran> trans;
+    text.parse(
+            [&](const thread_state& src_TS, const thread_state& dst_TS,
+                    const bool& is_spawn) {
+                if (!is_self_loop && src_TS == dst_TS) /// remove self loops
+                    return;
+                trans.emplace_back(ttdb_tran { src_TS.get_share(),
+                                src_TS.get_local(), dst_TS.get_share(),
+                                dst_TS.get_local(),
+                                is_spawn ? ttdb_tran::SPAWN : 0u });
+            });
+    ttdb::write(output, is_self_loop, trans);
 }
 
 } /* namespace sura */
@@ -9,11 +9,48 @@
 #define URA_HH_
 
 #include "../util/utilities.hh"
+#include "../util/ttdb.hh"
+#include "../util/concurrency.hh"
+#include "../util/zstream.hh"
 
 #include "tse.hh"
 
 namespace sura {
 
+/**
+ * @brief the transitions of a plain-text .ttd input. They are parsed from
+ *        the mapped file directly, or, if the file is compressed, from the
+ *        blocks a background thread decompresses it into. The header is
+ *        parsed on construction.
+ */
+class ttd_text {
+public:
+    ttd_text(const mapped_file& in);
+    ~ttd_text();
+
+    template<typename F>
+    void parse(F emit);
+
+private:
+    static const size_t PARALLEL_PARSE_SIZE;
+    static const size_t QUEUE_DEPTH;
+
+    const mapped_file& in;
+    const zstream::format format;
+    const char* first;              /// the position right after the header
+    blocking_queue<string> blocks;  /// decompressed blocks
+    string pending;                 /// decompressed text not parsed yet
+    bool is_eof;                    /// whether all blocks are in pending
+    size_t n_bytes;                 /// the number of decompressed bytes
+    std::unique_ptr<worker> inflater;
+
+    bool next_block();
+    template<typename F>
+    void parse_mapped(F emit);
+    template<typename F>
+    void parse_stream(F emit);
+};
+
 class ura {
 public:
     ura();
@@ -21,11 +58,25 @@ public:
     bool unbounded_reachability_analysis(const string& filename,
             const string& s_initl, const string& s_final,
             const bool& is_self_loop);
+    void compile_ttd(const string& filename, const string& output,
+            const bool& is_self_loop);
 
 private:
+    static const size_t BATCH_SIZE;
+    static const size_t PIPELINE_DEPTH;
+
     thread_state parse_input_tss(const string& str_ts);
     bool reachability_analysis_via_tse(const string& filename,
             const bool& is_self_loop);
+    bool reachability_analysis_via_ttd(const mapped_file& in,
+            const bool& is_self_loop);
+    bool reachability_analysis_via_ttdb(const ttdb& db,
+            const bool& is_self_loop);
+    void read_ttd(ttd_text& text, const bool& is_self_loop,
+            blocking_queue<tran_batch>& batches);
+    id_tran load_ttdb(const ttdb& db, const bool& is_self_loop,
+            incidence& l_matrix, incidence& s_matrix,
+            deque<id_tran>& spawn_vars);
 };
 
 } /* namespace sura */
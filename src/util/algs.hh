@@ -14,7 +14,38 @@
 namespace COMPARE {
 short compare(clong& x, clong& y);
 
-short compare_map(const map<ushort, ushort>& m1, const map<ushort, ushort>& m2);
+/**
+ * @brief compare maps
+ * @param m1
+ * @param m2
+ */
+template<typename K, typename V>
+short compare_map(const map<K, V>& m1, const map<K, V>& m2) {
+    auto s1_iter = m1.begin(), s1_end = m1.end();
+    auto s2_iter = m2.begin(), s2_end = m2.end();
+    while (true) {
+        if (s1_iter == s1_end && s2_iter == s2_end) {
+            return 0;
+        } else if (s1_iter == s1_end) {
+            return -1;
+        } else if (s2_iter == s2_end) {
+            return 1;
+        } else if (s1_iter->first < s2_iter->first) {
+            return -1;
+        } else if (s1_iter->first > s2_iter->first) {
+            return 1;
+        } else if (s1_iter->first == s2_iter->first) {
+            if (s1_iter->second < s2_iter->second) {
+                return -1;
+            } else if (s1_iter->second > s2_iter->second) {
+                return 1;
+            }
+        }
+        s1_iter++, s2_iter++;
+    }
+    throw ural_rt_err("COMPARE::compare: internal");
+}
+
 template<class T>
 short compare_container(const T& x, const T& y);
 }
@@ -0,0 +1,68 @@
+/**
+ * @name arena.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include <sys/mman.h>
+
+#include "arena.hh"
+
+namespace sura {
+
+/// the size of the first chunk
+const size_t arena::MIN_CHUNK = 1u << 20;
+/// chunks stop growing at this size; larger requests get their own chunk
+const size_t arena::MAX_CHUNK = 1u << 26;
+
+/**
+ * @brief constructor: no memory is mapped until the first allocation
+ * @param huge_pages: advise the kernel to back chunks by transparent huge
+ *        pages
+ */
+arena::arena(const bool& huge_pages) :
+        huge_pages(huge_pages), chunks(), cur(nullptr), end(nullptr), used(0), mapped(
+                0) {
+}
+
+arena::~arena() {
+    this->reset();
+}
+
+/**
+ * @brief release all allocations at once
+ */
+void arena::reset() {
+    for (auto it = chunks.begin(); it != chunks.end(); ++it)
+        ::munmap(it->first, it->second);
+    chunks.clear();
+    cur = end = nullptr;
+    used = mapped = 0;
+}
+
+/**
+ * @brief map a new chunk of at least the given size. The rest of the
+ *        current chunk is abandoned.
+ * @param bytes
+ */
+void arena::refill(const size_t& bytes) {
+    size_t length = chunks.empty() ?
+            MIN_CHUNK : std::min(chunks.back().second * 2, MAX_CHUNK);
+    if (length < bytes)
+        length = bytes;
+    void* addr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (addr == MAP_FAILED)
+        throw ural_rt_err("arena: out of memory");
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) /// only a hint: it fails silently without THP support
+        ::madvise(addr, length, MADV_HUGEPAGE);
+#endif
+    chunks.emplace_back(static_cast<char*>(addr), length);
+    cur = static_cast<char*>(addr);
+    end = cur + length;
+    mapped += length;
+}
+
+} /* namespace sura */
@@ -0,0 +1,136 @@
+/**
+ * @name arena.hh
+ *
+ * @brief the contiguous storage of the explicit-state search: a bump
+ *        allocator whose memory is released at once, and a ring-buffer
+ *        worklist
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef ARENA_HH_
+#define ARENA_HH_
+
+#include <cstdint>
+#include <cstring>
+
+#include "heads.hh"
+
+namespace sura {
+
+/**
+ * @brief a bump allocator over anonymous memory mappings. Allocations are
+ *        never freed one by one; reset releases all of them. Chunks grow
+ *        geometrically from MIN_CHUNK to MAX_CHUNK bytes and are committed
+ *        lazily by the kernel, so a small search touches few pages.
+ */
+class arena {
+public:
+    arena(const bool& huge_pages = false);
+    ~arena();
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    /**
+     * @brief allocate uninitialized memory
+     * @param bytes
+     * @param align: a power of 2
+     * @return char*
+     */
+    inline char* allocate(const size_t& bytes, const size_t& align = 8) {
+        char* p = reinterpret_cast<char*>(
+                (reinterpret_cast<uintptr_t>(cur) + align - 1) & ~(align - 1));
+        if (end - p < std::ptrdiff_t(bytes)) {
+            this->refill(bytes + align);
+            p = reinterpret_cast<char*>(
+                    (reinterpret_cast<uintptr_t>(cur) + align - 1)
+                            & ~(align - 1));
+        }
+        cur = p + bytes;
+        used += bytes;
+        return p;
+    }
+
+    void reset();
+
+    /// the number of bytes allocated
+    inline size_t size() const {
+        return used;
+    }
+
+    /// the number of bytes mapped
+    inline size_t capacity() const {
+        return mapped;
+    }
+
+private:
+    static const size_t MIN_CHUNK;
+    static const size_t MAX_CHUNK;
+
+    bool huge_pages;
+    vector<pair<char*, size_t>> chunks;
+    char* cur;
+    char* end;
+    size_t used;
+    size_t mapped;
+
+    void refill(const size_t& bytes);
+};
+
+/**
+ * @brief a FIFO queue in one contiguous buffer whose capacity is a power of
+ *        2. It doubles when full; nothing is allocated per item.
+ */
+template<typename T>
+class ring_queue {
+public:
+    inline ring_queue() :
+            buf(16), head(0), tail(0) {
+    }
+
+    ~ring_queue() {
+    }
+
+    inline bool empty() const {
+        return head == tail;
+    }
+
+    inline size_t size() const {
+        return tail - head;
+    }
+
+    inline const T& front() const {
+        return buf[head & (buf.size() - 1)];
+    }
+
+    inline void pop() {
+        ++head;
+    }
+
+    inline void push(const T& x) {
+        if (tail - head == buf.size())
+            this->grow();
+        buf[tail++ & (buf.size() - 1)] = x;
+    }
+
+private:
+    vector<T> buf;
+    size_t head; /// both grow monotonically and are masked on access
+    size_t tail;
+
+    /// double the buffer and unwrap the items to its beginning
+    void grow() {
+        vector<T> _buf(buf.size() * 2);
+        const size_t n = tail - head;
+        for (size_t i = 0; i < n; ++i)
+            _buf[i] = buf[(head + i) & (buf.size() - 1)];
+        buf.swap(_buf);
+        head = 0, tail = n;
+    }
+};
+
+} /* namespace sura */
+
+#endif /* ARENA_HH_ */
@@ -228,6 +228,9 @@ void cmd_line::create_argument_list() {
     this->add_option(prob_inst_opts(), "-i", "--initial",
             "an initial thread state (e.g., 0|0)", "0|0");
 
+    this->add_option(prob_inst_opts(), "-c", "--compile",
+            "compile the .ttd file into a binary .ttdb file and exit", "X");
+
     this->add_switch(prob_inst_opts(), "-l", "--adj-list",
             "show the adjacency list");
 //	this->add_switch(prob_inst_opts(), "-dot", "--ettd2dot",
@@ -238,8 +241,31 @@ void cmd_line::create_argument_list() {
 //			"the number of threads at initial state", "1");
 //	this->add_option(exp_mode_opts(), "-z", "--spawn-threads",
 //			"the maximal number of spawn threads", "0");
+    this->add_option(exp_mode_opts(), "-e", "--engine",
+            "the engine: fws (explicit), astar (explicit, best first), mdd "
+                    "(symbolic) or km (Karp-Miller)",
+            "fws");
+    this->add_option(exp_mode_opts(), "-t", "--threads",
+            "the number of workers of the explicit search, 0 for all cores",
+            "1");
+    this->add_option(exp_mode_opts(), "-r", "--refinements",
+            "the CEGAR rounds before the Karp-Miller tree decides, 16 by "
+                    "default; 0 for unbounded CEGAR without the tree",
+            "16");
     this->add_switch(exp_mode_opts(), "-vs", "--self-loop",
             "keep the self-loops");
+    this->add_switch(exp_mode_opts(), "-hp", "--huge-pages",
+            "back the explicit search by transparent huge pages");
+    this->add_switch(exp_mode_opts(), "-cz", "--compress-states",
+            "store visited states as varints to save memory");
+    this->add_switch(exp_mode_opts(), "-bws", "--backward",
+            "decide by the backward search what the equation cannot");
+    this->add_switch(exp_mode_opts(), "-ac", "--antichain",
+            "keep only maximal states in the explicit search with spawns");
+    this->add_switch(exp_mode_opts(), "-por", "--partial-order",
+            "fire thread-local transitions eagerly in the explicit search");
+    this->add_switch(exp_mode_opts(), "-ss", "--sleep-sets",
+            "skip commuting local transitions in the explicit search");
 
     this->add_switch(exp_mode_opts(), "-ce", "--counterexample",
             "show counterexample");
@@ -250,6 +276,8 @@ void cmd_line::create_argument_list() {
     /// other options
     this->add_switch(other_opts(), "-cmd", "--cmd-line",
             "show the command line");
+    this->add_switch(other_opts(), "-stat", "--statistics",
+            "show statistic information");
     this->add_switch(other_opts(), "-all", "--all",
             "show all of above messages");
     this->add_switch(other_opts(), SHORT_VERSION_OPT, LONG_VERSION_OPT,
@@ -0,0 +1,306 @@
+/**
+ * @name concurrency.hh
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef CONCURRENCY_HH_
+#define CONCURRENCY_HH_
+
+#include <cstdint>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "heads.hh"
+
+namespace sura {
+
+/**
+ * @brief a bounded FIFO queue connecting a producer and a consumer thread.
+ *        push blocks while the queue is full, pop blocks while it is empty.
+ *        Once closed, push drops its item and pop drains the remaining ones.
+ */
+template<typename T>
+class blocking_queue {
+public:
+    inline blocking_queue(const size_t& capacity) :
+            capacity(capacity), closed(false), items(), mtx(), not_full(),
+            not_empty() {
+    }
+
+    ~blocking_queue() {
+    }
+
+    /**
+     * @brief append an item
+     * @param item
+     * @return bool
+     *         true : if the item is queued
+     *         false: if the queue is closed
+     */
+    inline bool push(T&& item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_full.wait(lock, [this] {return closed || items.size() < capacity;});
+        if (closed)
+            return false;
+        items.emplace_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief remove the first item
+     * @param item
+     * @return bool
+     *         true : if an item is removed
+     *         false: if the queue is closed and empty
+     */
+    inline bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        not_empty.wait(lock, [this] {return closed || !items.empty();});
+        if (items.empty())
+            return false;
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief close the queue and wake up all waiting threads
+     */
+    inline void close() {
+        std::lock_guard<std::mutex> lock(mtx);
+        closed = true;
+        not_full.notify_all();
+        not_empty.notify_all();
+    }
+
+private:
+    const size_t capacity;
+    bool closed;
+    deque<T> items;
+    std::mutex mtx;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+};
+
+/**
+ * @brief a background thread that keeps the exception it terminates with,
+ *        so the exception can be rethrown in the thread joining it
+ */
+class worker {
+public:
+    template<typename F>
+    inline worker(F f) :
+            error(), is_failed(false), th() {
+        th = std::thread([this, f]() {
+            try {
+                f();
+            } catch (...) {
+                error = std::current_exception();
+                is_failed = true;
+            }
+        });
+    }
+
+    inline ~worker() {
+        if (th.joinable())
+            th.join();
+    }
+
+    worker(const worker&) = delete;
+    worker& operator=(const worker&) = delete;
+
+    /**
+     * @brief wait for the thread and rethrow its exception, if any
+     */
+    inline void join() {
+        th.join();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    /**
+     * @brief determine if the thread terminated with an exception. Safe to
+     *        call while it is running.
+     * @return bool
+     */
+    inline bool failed() const {
+        return is_failed;
+    }
+
+private:
+    std::exception_ptr error;
+    std::atomic<bool> is_failed;
+    std::thread th;
+};
+
+/**
+ * @brief the exponential backoff of an idle thread polling for work: it
+ *        yields a few times, then sleeps for 1, 2, 4, ... microseconds, up
+ *        to MAX_SLEEP, so idle threads do not pin their cores
+ */
+class backoff {
+public:
+    inline backoff() :
+            n(0) {
+    }
+
+    /**
+     * @brief wait a bit longer than the last time
+     */
+    inline void pause() {
+        if (n < N_YIELDS) {
+            std::this_thread::yield();
+        } else {
+            const uint32_t us = std::min(uint32_t(1) << (n - N_YIELDS),
+                    uint32_t(MAX_SLEEP));
+            std::this_thread::sleep_for(std::chrono::microseconds(us));
+        }
+        if (n < N_YIELDS + 16)
+            ++n;
+    }
+
+    /**
+     * @brief start over once there is work again
+     */
+    inline void reset() {
+        n = 0;
+    }
+
+private:
+    static const uint32_t N_YIELDS = 4;
+    static const uint32_t MAX_SLEEP = 1000; /// in microseconds
+
+    uint32_t n; /// the pauses since the last reset
+};
+
+/**
+ * @brief the deque of one worker in a work-stealing pool, after Chase and
+ *        Lev, with the memory orders of Le et al. (PPoPP 2013): the owner
+ *        pushes and pops ids at the bottom, other workers steal them from
+ *        the top, all without locks. Only the last id is raced for, by a
+ *        CAS on top. The circular array doubles when full; the old arrays
+ *        are kept until the deque is destroyed, as thieves may still read
+ *        them.
+ */
+class work_deque {
+public:
+    inline work_deque() :
+            top(0), bottom(0), array(nullptr), arrays() {
+        arrays.emplace_back(new ring(INITIAL_SIZE));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    ~work_deque() {
+    }
+
+    work_deque(const work_deque&) = delete;
+    work_deque& operator=(const work_deque&) = delete;
+
+    /**
+     * @brief append an id at the bottom; only the owner calls it
+     * @param x
+     */
+    inline void push(const uint64_t& x) {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t t = top.load(std::memory_order_acquire);
+        ring* a = array.load(std::memory_order_relaxed);
+        if (b - t > int64_t(a->mask))
+            a = this->grow(a, t, b);
+        a->at(b).store(x, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief remove the last id; only the owner calls it
+     * @param x: the id
+     * @return bool: false if the deque is empty
+     */
+    inline bool pop(uint64_t& x) {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        ring* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) { /// empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        x = a->at(b).load(std::memory_order_relaxed);
+        if (t < b)
+            return true;
+        /// the last id: thieves may take it as well
+        const bool is_won = top.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return is_won;
+    }
+
+    /**
+     * @brief remove the first id, i.e., the oldest one
+     * @param x: the id
+     * @return bool: false if the deque is empty or another thread took
+     *         the id first
+     */
+    inline bool steal(uint64_t& x) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return false;
+        const ring* a = array.load(std::memory_order_acquire);
+        x = a->at(t).load(std::memory_order_relaxed);
+        return top.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+private:
+    enum {
+        INITIAL_SIZE = 1 << 10
+    };
+
+    /// a circular array of a power of 2 ids
+    struct ring {
+        inline ring(const size_t& size) :
+                slots(new std::atomic<uint64_t>[size]), mask(size - 1) {
+        }
+
+        inline std::atomic<uint64_t>& at(const int64_t& i) const {
+            return slots[i & mask];
+        }
+
+        std::unique_ptr<std::atomic<uint64_t>[]> slots;
+        const size_t mask;
+    };
+
+    std::atomic<int64_t> top;    /// the next id to steal
+    std::atomic<int64_t> bottom; /// the next slot to push to
+    std::atomic<ring*> array;
+    vector<std::unique_ptr<ring>> arrays; /// all arrays, grown by the owner
+
+    /**
+     * @brief double the array, holding the ids top ... bottom - 1
+     * @param a
+     * @param t: top
+     * @param b: bottom
+     * @return ring*: the new array
+     */
+    ring* grow(const ring* a, const int64_t& t, const int64_t& b) {
+        arrays.emplace_back(new ring(2 * (a->mask + 1)));
+        ring* na = arrays.back().get();
+        for (int64_t i = t; i < b; ++i)
+            na->at(i).store(a->at(i).load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+        array.store(na, std::memory_order_release);
+        return na;
+    }
+};
+
+} /* namespace sura */
+
+#endif /* CONCURRENCY_HH_ */
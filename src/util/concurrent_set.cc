@@ -0,0 +1,224 @@
+/**
+ * @name concurrent_set.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "concurrent_set.hh"
+
+namespace sura {
+
+const uint64_t concurrent_set::FROZEN;
+const uint64_t concurrent_set::TAG_MASK;
+const uint64_t concurrent_set::ID_MASK;
+
+/**
+ * @brief constructor: an empty table of the given capacity, a power of 2
+ * @param capacity
+ */
+concurrent_set::table::table(const size_t& capacity) :
+        slots(new std::atomic<uint64_t>[capacity]()), mask(capacity - 1), count(
+                0), next(nullptr), claimed(0), migrated(0) {
+}
+
+/**
+ * @brief constructor
+ * @param words        : the words of a state
+ * @param payload_words: the words of the payload of a state
+ */
+concurrent_set::concurrent_set(const size_t& words, const size_t& payload_words) :
+        k(words), width(words + payload_words), blocks(
+                new std::atomic<uint64_t*>[MAX_BLOCKS]()), n_ids(0), n_states(
+                0), current(nullptr), first(new table(INITIAL_SLOTS)), n_resizes(
+                0) {
+    if (words == 0)
+        throw ural_rt_err("concurrent_set: empty states");
+    current = first;
+}
+
+concurrent_set::~concurrent_set() {
+    for (table* t = first; t != nullptr;) {
+        table* next = t->next.load();
+        delete t;
+        t = next;
+    }
+    for (size_t b = 0; b < MAX_BLOCKS; ++b)
+        delete[] blocks[b].load();
+}
+
+ostream& concurrent_set::print_stat(ostream& out) const {
+    const table* t = current.load();
+    out << "visited: " << this->size() << " states, " << t->mask + 1
+            << " slots, " << PPRINT::plural(n_resizes.load(), "resize")
+            << ", " << this->size() * k * sizeof(uint64_t) / 1024
+            << " KiB of states";
+    return out;
+}
+
+/**
+ * @brief make sure the block of a reserved id exists. The threads racing to
+ *        allocate it agree by a CAS; the losers free theirs.
+ * @param i
+ */
+void concurrent_set::allocate(const id& i) {
+    std::atomic<uint64_t*>& b = blocks[i >> BLOCK_BITS];
+    if (b.load(std::memory_order_acquire) != nullptr)
+        return;
+    uint64_t* p = new uint64_t[size_t(BLOCK) * width];
+    uint64_t* expected = nullptr;
+    if (!b.compare_exchange_strong(expected, p, std::memory_order_acq_rel))
+        delete[] p;
+}
+
+/**
+ * @brief start doubling a table unless it is started already, and help to
+ *        finish it
+ * @param t
+ * @return table*: the new table
+ */
+concurrent_set::table* concurrent_set::grow(table* t) {
+    if (t->next.load(std::memory_order_acquire) == nullptr) {
+        table* nt = new table((t->mask + 1) * 2);
+        table* expected = nullptr;
+        if (t->next.compare_exchange_strong(expected, nt,
+                std::memory_order_acq_rel))
+            ++n_resizes;
+        else
+            delete nt;
+    }
+    return this->migrate(t);
+}
+
+/**
+ * @brief help to migrate a table to its next one: claim chunks of slots,
+ *        freeze every slot so that no state can be inserted there anymore,
+ *        and move the ids into the next table. Returns once every chunk is
+ *        moved, so that all states of t are found in the next table: it
+ *        waits for the chunks that others claimed, so it blocks.
+ * @param t: a table whose next table exists
+ * @return table*: the next table
+ */
+concurrent_set::table* concurrent_set::migrate(table* t) {
+    table* nt = t->next.load(std::memory_order_acquire);
+    const size_t capacity = t->mask + 1;
+    const size_t n_chunks = (capacity + CHUNK - 1) / CHUNK;
+    size_t c;
+    while ((c = t->claimed.fetch_add(1)) < n_chunks) {
+        size_t moved = 0;
+        for (size_t i = c * CHUNK; i < std::min((c + 1) * CHUNK, capacity);
+                ++i) {
+            uint64_t v = t->slots[i].load(std::memory_order_acquire);
+            while (!t->slots[i].compare_exchange_weak(v, v | FROZEN,
+                    std::memory_order_acq_rel))
+                ;
+            if (v == 0)
+                continue;
+            size_t j = this->hash(this->record((v & ID_MASK) - 1)) & nt->mask;
+            for (uint64_t empty = 0; !nt->slots[j].compare_exchange_strong(
+                    empty, v, std::memory_order_acq_rel); empty = 0)
+                j = (j + 1) & nt->mask;
+            ++moved;
+        }
+        nt->count.fetch_add(moved);
+        t->migrated.fetch_add(1, std::memory_order_release);
+    }
+    while (t->migrated.load(std::memory_order_acquire) < n_chunks)
+        std::this_thread::yield();
+    table* expected = t;
+    current.compare_exchange_strong(expected, nt);
+    return nt;
+}
+
+/**
+ * @brief constructor
+ * @param set
+ */
+concurrent_set::handle::handle(concurrent_set& set) :
+        set(set), next(0), last(0), n_new(0) {
+}
+
+concurrent_set::handle::~handle() {
+    set.n_states.fetch_add(n_new);
+}
+
+/**
+ * @brief reserve the next range of ids
+ */
+void concurrent_set::handle::reserve() {
+    next = set.n_ids.fetch_add(RANGE);
+    if (next >= uint64_t(BLOCK) * MAX_BLOCKS)
+        throw ural_rt_err("concurrent_set: too many states");
+    last = next + RANGE;
+    set.allocate(next);
+}
+
+/**
+ * @brief add the inserts of this handle to the counts, and double the table
+ *        if it is half full
+ */
+void concurrent_set::handle::flush() {
+    set.n_states.fetch_add(n_new);
+    table* t = set.current.load(std::memory_order_acquire);
+    if (t->count.fetch_add(n_new) + n_new > (t->mask + 1) / 2)
+        set.grow(t);
+    n_new = 0;
+}
+
+/**
+ * @brief insert a state unless it is in the set already
+ * @param w      : the state
+ * @param payload: its payload words, stored only if w is new; may be
+ *                 nullptr, then the payload is left uninitialized
+ * @return pair<id, bool>
+ *         first : the id of w
+ *         second: true if w is new
+ */
+pair<concurrent_set::id, bool> concurrent_set::handle::insert(
+        const uint64_t* w, const uint64_t* payload) {
+    const uint64_t h = set.hash(w);
+    const uint64_t tag = h & TAG_MASK;
+    table* t = set.current.load(std::memory_order_acquire);
+    size_t i = h & t->mask, p = 0;
+    bool is_written = false; /// whether the record of next holds w
+    while (true) {
+        if (p > MAX_PROBES) { /// clustered: no more probing in t
+            t = set.grow(t);
+            i = h & t->mask, p = 0;
+            continue;
+        }
+        uint64_t v = t->slots[i].load(std::memory_order_acquire);
+        if (v == 0) {
+            if (next == last)
+                this->reserve(), is_written = false;
+            if (!is_written) {
+                std::memcpy(set.record(next), w, set.k * sizeof(uint64_t));
+                is_written = true;
+            }
+            if (payload != nullptr)
+                std::memcpy(set.payload(next), payload,
+                        (set.width - set.k) * sizeof(uint64_t));
+            if (t->slots[i].compare_exchange_strong(v, tag | (next + 1),
+                    std::memory_order_acq_rel)) {
+                const id j = next++;
+                if (++n_new == BATCH)
+                    this->flush();
+                return std::make_pair(j, true);
+            }
+            /// lost the slot: v is its value now, check it below
+        }
+        if (v & FROZEN) { /// t is migrated: carry on in the next table
+            t = set.migrate(t);
+            i = h & t->mask, p = 0;
+            continue;
+        }
+        if ((v & TAG_MASK) == tag) {
+            const id j = (v & ID_MASK) - 1;
+            if (set.equal(set.record(j), w))
+                return std::make_pair(j, false);
+        }
+        i = (i + 1) & t->mask, ++p;
+    }
+}
+
+} /* namespace sura */
@@ -0,0 +1,164 @@
+/**
+ * @name concurrent_set.hh
+ *
+ * @brief a concurrent set of fixed-width states shared by the workers of a
+ *        parallel search
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef CONCURRENT_SET_HH_
+#define CONCURRENT_SET_HH_
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+
+#include "visited.hh"
+
+namespace sura {
+
+/**
+ * @brief an open-addressing set of states of a fixed number of words,
+ *        e.g., packed global states, each with a fixed number of payload
+ *        words stored next to it, e.g., the id of its parent. Inserts take
+ *        no lock, but the doubling of the table blocks, see below.
+ *
+ *        A state is stored once as a record, whose index is its id, and a
+ *        slot of the table holds the id tagged with the upper bits of the
+ *        state's hash. Threads insert through handles of their own: a
+ *        handle reserves ids in ranges and counts its inserts in batches,
+ *        so inserting a new state takes a single CAS on its slot in the
+ *        common case. Records are written before they are published by that
+ *        CAS and are never changed afterwards, except for their payloads.
+ *
+ *        The table doubles online: the threads that find it too full or
+ *        hit a migrated slot help to migrate it chunk by chunk, freezing
+ *        every slot they move, and carry on in the new table once all chunks
+ *        are moved. The migration blocks: until a migrator has moved the
+ *        chunks it claimed, the others wait for it, so a preempted one
+ *        stalls every insert meanwhile. Old tables are kept until the set
+ *        is destroyed, as slow threads may still read them.
+ */
+class concurrent_set {
+public:
+    typedef uint64_t id;
+
+    /**
+     * @brief the access of one thread to the set
+     */
+    class handle {
+    public:
+        handle(concurrent_set& set);
+        ~handle();
+
+        handle(const handle&) = delete;
+        handle& operator=(const handle&) = delete;
+
+        pair<id, bool> insert(const uint64_t* w, const uint64_t* payload =
+                nullptr);
+
+    private:
+        concurrent_set& set;
+        id next;      /// the reserved ids are next ... last - 1
+        id last;
+        size_t n_new; /// the inserts not counted in the set yet
+
+        void reserve();
+        void flush();
+    };
+
+    concurrent_set(const size_t& words, const size_t& payload_words = 0);
+    ~concurrent_set();
+
+    concurrent_set(const concurrent_set&) = delete;
+    concurrent_set& operator=(const concurrent_set&) = delete;
+
+    /**
+     * @brief the hash of a state
+     * @param w
+     * @return uint64_t
+     */
+    inline uint64_t hash(const uint64_t* w) const {
+        uint64_t h = zobrist::mix(w[0] ^ 0x9e3779b97f4a7c15ull);
+        for (size_t i = 1; i < k; ++i)
+            h = zobrist::mix(h ^ w[i]);
+        return h;
+    }
+
+    /// the state of an id returned by insert
+    inline const uint64_t* operator[](const id& i) const {
+        return this->record(i);
+    }
+
+    /// the payload words of an id returned by insert
+    inline uint64_t* payload(const id& i) {
+        return this->record(i) + k;
+    }
+
+    inline size_t words() const {
+        return k;
+    }
+
+    /// the number of states; only exact once all handles are destroyed
+    inline size_t size() const {
+        return n_states.load();
+    }
+
+    ostream& print_stat(ostream& out = cout) const;
+
+private:
+    static const uint64_t FROZEN = uint64_t(1) << 63;
+    static const uint64_t TAG_MASK = 0x7fffff0000000000ull;
+    static const uint64_t ID_MASK = 0x000000ffffffffffull;
+
+    enum {
+        BLOCK_BITS = 16, BLOCK = 1 << BLOCK_BITS, /// records per block
+        MAX_BLOCKS = 1 << 16,                     /// so ids fit in 32 bits
+        RANGE = 256,         /// ids reserved at once, a divisor of BLOCK
+        BATCH = 32,          /// inserts counted at once
+        CHUNK = 4096,        /// slots migrated at once
+        MAX_PROBES = 256,    /// a longer probe doubles the table
+        INITIAL_SLOTS = 1 << 16
+    };
+
+    struct table {
+        table(const size_t& capacity);
+        std::unique_ptr<std::atomic<uint64_t>[]> slots; /// 0 if empty
+        const size_t mask;
+        std::atomic<size_t> count;    /// the inserted states, roughly
+        std::atomic<table*> next;     /// the table it migrates to
+        std::atomic<size_t> claimed;  /// the chunks claimed by migrators
+        std::atomic<size_t> migrated; /// the chunks migrated
+    };
+
+    const size_t k;       /// the words of a state
+    const size_t width;   /// the words of a record: state and payload
+    std::unique_ptr<std::atomic<uint64_t*>[]> blocks;
+    std::atomic<id> n_ids;       /// the ids reserved by handles
+    std::atomic<size_t> n_states;
+    std::atomic<table*> current; /// the table new states go to
+    table* first;                /// the oldest table, which owns the others
+    std::atomic<size_t> n_resizes;
+
+    inline uint64_t* record(const id& i) const {
+        return blocks[i >> BLOCK_BITS].load(std::memory_order_acquire)
+                + (i & (BLOCK - 1)) * width;
+    }
+
+    inline bool equal(const uint64_t* a, const uint64_t* b) const {
+        for (size_t i = 0; i < k; ++i)
+            if (a[i] != b[i])
+                return false;
+        return true;
+    }
+
+    void allocate(const id& i);
+    table* grow(table* t);
+    table* migrate(table* t);
+};
+
+} /* namespace sura */
+
+#endif /* CONCURRENT_SET_HH_ */
@@ -0,0 +1,72 @@
+/**
+ * @name csr.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "csr.hh"
+
+namespace sura {
+
+adj_csr::adj_csr() :
+        offs(), edges(), staged(), active(), words(0) {
+}
+
+adj_csr::~adj_csr() {
+}
+
+/**
+ * @brief stage an edge src -> dst, or src +> dst if is_spawn
+ * @param src
+ * @param dst
+ * @param is_spawn
+ */
+void adj_csr::add(const thread_state& src, const thread_state& dst,
+        const bool& is_spawn) {
+    staged.emplace_back(src, csr_edge { dst, is_spawn });
+}
+
+/**
+ * @brief build the rows from the staged edges by a counting sort on the
+ *        source, which keeps the staging order within every row
+ */
+void adj_csr::build() {
+    const id_thread_state n = id_thread_state(thread_state::S)
+            * thread_state::L;
+    offs.assign(n + 1, 0);
+    for (auto it = staged.begin(); it != staged.end(); ++it)
+        ++offs[it->first.get_id() + 1];
+    for (id_thread_state v = 0; v < n; ++v)
+        offs[v + 1] += offs[v];
+
+    edges.resize(staged.size());
+    vector<id_tran> pos(offs.begin(), offs.end() - 1);
+    for (auto it = staged.begin(); it != staged.end(); ++it)
+        edges[pos[it->first.get_id()]++] = it->second;
+    vector<pair<thread_state, csr_edge>>().swap(staged);
+
+    words = (thread_state::L + 63) / 64;
+    active.assign(thread_state::S * words, 0);
+    for (id_thread_state v = 0; v < n; ++v) {
+        if (offs[v + 1] > offs[v]) {
+            const thread_state t(v);
+            active[t.get_share() * words + (t.get_local() >> 6)] |=
+                    uint64_t(1) << (t.get_local() & 63);
+        }
+    }
+}
+
+/**
+ * @brief build the rows from the transitions of a .ttdb file directly
+ * @param trans: transitions in transition-ID order
+ */
+void adj_csr::build(const array_view<ttdb_tran>& trans) {
+    staged.reserve(trans.size());
+    for (auto it = trans.begin(); it != trans.end(); ++it)
+        this->add(thread_state(it->s1, it->l1), thread_state(it->s2, it->l2),
+                it->flags & ttdb_tran::SPAWN);
+    this->build();
+}
+
+} /* namespace sura */
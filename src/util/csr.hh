@@ -0,0 +1,100 @@
+/**
+ * @name csr.hh
+ *
+ * @brief the thread-state transition diagram in compressed sparse row form
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef CSR_HH_
+#define CSR_HH_
+
+#include "ttdb.hh"
+
+namespace sura {
+
+/// an edge of adj_csr: the destination and whether it is a spawn
+/// transition, so that the spawn check needs no lookup
+struct csr_edge {
+    thread_state dst;
+    bool is_spawn;
+};
+
+/**
+ * @brief the adjacency lists of all thread states in compressed sparse row
+ *        form: the outgoing edges of thread state (s|l) are stored
+ *        contiguously in edges[offs[v]] ... edges[offs[v + 1] - 1], where
+ *        v is the id of (s|l). The edges of a thread state keep the order they
+ *        are added in.
+ *
+ *        Edges are staged via add and become visible after build, which
+ *        also marks, for each shared state, the local states that have
+ *        outgoing edges in a bitset of source_words() words.
+ */
+class adj_csr {
+public:
+    adj_csr();
+    ~adj_csr();
+
+    void add(const thread_state& src, const thread_state& dst,
+            const bool& is_spawn);
+    void build();
+    void build(const array_view<ttdb_tran>& trans);
+
+    /**
+     * @brief the outgoing edges of a thread state
+     * @param src
+     * @return array_view<csr_edge>
+     */
+    inline array_view<csr_edge> successors(const thread_state& src) const {
+        const id_thread_state v = src.get_id();
+        if (v + 1 >= offs.size())
+            return array_view<csr_edge>();
+        return array_view<csr_edge>(edges.data() + offs[v],
+                offs[v + 1] - offs[v]);
+    }
+
+    /**
+     * @brief the local states with outgoing edges under a shared state
+     * @param s
+     * @return the bitset: bit l % 64 of word l / 64 is set iff (s|l) has
+     *         an outgoing edge
+     */
+    inline const uint64_t* sources(const shared_state& s) const {
+        return active.data() + s * words;
+    }
+
+    /// the number of words of the bitset of each shared state
+    inline size_t source_words() const {
+        return words;
+    }
+
+    /// whether a thread state has outgoing edges
+    inline bool is_source(const thread_state& t) const {
+        const local_state& l = t.get_local();
+        return t.get_share() < thread_state::S && l < thread_state::L
+                && (this->sources(t.get_share())[l >> 6] >> (l & 63)) & 1;
+    }
+
+    /// the number of thread states, i.e., S * L
+    inline size_t size() const {
+        return offs.empty() ? 0 : offs.size() - 1;
+    }
+
+    /// the number of edges
+    inline size_t size_edges() const {
+        return edges.size();
+    }
+
+private:
+    vector<id_tran> offs;
+    vector<csr_edge> edges;
+    vector<pair<thread_state, csr_edge>> staged;
+    vector<uint64_t> active;
+    size_t words;
+};
+
+} /* namespace sura */
+
+#endif /* CSR_HH_ */
@@ -31,6 +31,10 @@
 #include <iterator>
 #include <algorithm>
 #include <memory>
+#include <limits>
+#include <thread>
+#include <future>
+#include <chrono>
 
 #include "debug.hh"
 #include "excep.hh"
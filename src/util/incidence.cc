@@ -0,0 +1,145 @@
+/**
+ * @name incidence.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "incidence.hh"
+
+namespace sura {
+
+/**
+ * @brief constructor: the matrix with no row
+ */
+incidence::incidence() :
+        offs_store(), ids_store(), in_offs(), in_ids(), out_offs(), out_ids() {
+}
+
+/**
+ * @brief constructor: view the incidence sections of a mapped .ttdb file.
+ *        Nothing is copied; the file must outlive the matrix.
+ * @param db
+ * @param in_offs : the offsets of incoming transitions; the ID section comes
+ *                  right after it
+ * @param out_offs: the offsets of outgoing transitions, likewise
+ */
+incidence::incidence(const ttdb& db, const ttdb::section& in_offs,
+        const ttdb::section& out_offs) :
+        offs_store(), ids_store(), in_offs(db.get_offsets(in_offs)), in_ids(
+                db.get_ids(ttdb::section(in_offs + 1))), out_offs(
+                db.get_offsets(out_offs)), out_ids(
+                db.get_ids(ttdb::section(out_offs + 1))) {
+    const uint64_t n_trans = db.get_trans().size();
+    validate(this->in_offs, this->in_ids, n_trans);
+    validate(this->out_offs, this->out_ids, n_trans);
+}
+
+incidence::~incidence() {
+}
+
+/**
+ * @brief the incidence matrix of local states
+ * @param L
+ * @param trans: transitions in transition-ID order
+ * @return incidence
+ */
+incidence incidence::of_locals(const uint32_t& L,
+        const vector<ttdb_tran>& trans) {
+    return build(L, trans, [](const ttdb_tran& t, uint32_t& v) {
+        v = t.l2;
+        return true;
+    }, [](const ttdb_tran& t, uint32_t& v) {
+        v = t.l1;
+        return true;
+    });
+}
+
+/**
+ * @brief the incidence matrix of shared states. A transition that keeps its
+ *        shared state has no entry.
+ * @param S
+ * @param trans: transitions in transition-ID order
+ * @return incidence
+ */
+incidence incidence::of_shareds(const uint32_t& S,
+        const vector<ttdb_tran>& trans) {
+    return build(S, trans, [](const ttdb_tran& t, uint32_t& v) {
+        v = t.s2;
+        return t.s1 != t.s2;
+    }, [](const ttdb_tran& t, uint32_t& v) {
+        v = t.s1;
+        return t.s1 != t.s2;
+    });
+}
+
+/**
+ * @brief build an owning matrix of n rows
+ * @param n
+ * @param trans
+ * @param in_key : selects the row a transition enters
+ * @param out_key: selects the row a transition leaves
+ * @return incidence
+ */
+incidence incidence::build(const uint32_t& n, const vector<ttdb_tran>& trans,
+        const key_fn& in_key, const key_fn& out_key) {
+    incidence m;
+    build_half(n, trans, in_key, m.offs_store[0], m.ids_store[0]);
+    build_half(n, trans, out_key, m.offs_store[1], m.ids_store[1]);
+    m.in_offs = array_view<uint64_t>(m.offs_store[0].data(),
+            m.offs_store[0].size());
+    m.in_ids = array_view<uint32_t>(m.ids_store[0].data(),
+            m.ids_store[0].size());
+    m.out_offs = array_view<uint64_t>(m.offs_store[1].data(),
+            m.offs_store[1].size());
+    m.out_ids = array_view<uint32_t>(m.ids_store[1].data(),
+            m.ids_store[1].size());
+    return m;
+}
+
+/**
+ * @brief build one CSR half by counting sort: for every state v, the IDs of
+ *        all transitions t with key(t) == v, in ascending order
+ * @param n   : the number of states
+ * @param trans
+ * @param key
+ * @param offs: offsets, size n + 1
+ * @param ids : transition IDs
+ */
+void incidence::build_half(const uint32_t& n, const vector<ttdb_tran>& trans,
+        const key_fn& key, vector<uint64_t>& offs, vector<uint32_t>& ids) {
+    offs.assign(n + 1ul, 0);
+    uint32_t v;
+    for (auto it = trans.begin(); it != trans.end(); ++it)
+        if (key(*it, v))
+            ++offs[v + 1ul];
+    for (uint32_t i = 0; i < n; ++i)
+        offs[i + 1ul] += offs[i];
+
+    ids.resize(offs[n]);
+    vector<uint64_t> pos(offs.begin(), offs.end() - 1);
+    for (size_t id = 0; id < trans.size(); ++id)
+        if (key(trans[id], v))
+            ids[pos[v]++] = id;
+}
+
+/**
+ * @brief check that a CSR half read from a file is well formed, so that rows
+ *        can be accessed unchecked
+ * @param offs
+ * @param ids
+ * @param n_trans: the number of transitions, i.e., columns
+ */
+void incidence::validate(const array_view<uint64_t>& offs,
+        const array_view<uint32_t>& ids, const uint64_t& n_trans) {
+    if (offs.size() == 0 || offs[0] != 0 || offs[offs.size() - 1] != ids.size())
+        throw ural_rt_err("incidence: corrupted offsets");
+    for (size_t v = 0; v + 1 < offs.size(); ++v)
+        if (offs[v] > offs[v + 1])
+            throw ural_rt_err("incidence: corrupted offsets");
+    for (auto it = ids.begin(); it != ids.end(); ++it)
+        if (*it >= n_trans)
+            throw ural_rt_err("incidence: transition ID out of range");
+}
+
+} /* namespace sura */
@@ -0,0 +1,109 @@
+/**
+ * @name incidence.hh
+ *
+ * @brief the incidence matrix of the thread-state equation in compressed
+ *        sparse row form
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef INCIDENCE_HH_
+#define INCIDENCE_HH_
+
+#include "ttdb.hh"
+
+namespace sura {
+
+/**
+ * @brief the incidence matrix of local or shared states: rows are states,
+ *        columns are transitions. Entry (v, t) is +1 if t enters v and -1 if
+ *        t leaves v; both are stored for a local self-loop, whose net effect
+ *        is 0. The +1 and -1 entries of every row are kept apart, as two CSR
+ *        halves: row v has the incoming transitions
+ *        in_ids[in_offs[v]] ... in_ids[in_offs[v + 1] - 1] in ascending
+ *        order, and likewise the outgoing ones.
+ *
+ *        The matrix either owns its arrays or views the sections of a
+ *        mapped .ttdb file, which store exactly this form.
+ */
+class incidence {
+public:
+    incidence();
+    incidence(const ttdb& db, const ttdb::section& in_offs,
+            const ttdb::section& out_offs);
+    ~incidence();
+
+    incidence(const incidence&) = delete;
+    incidence& operator=(const incidence&) = delete;
+    incidence(incidence&&) = default;
+    incidence& operator=(incidence&&) = default;
+
+    static incidence of_locals(const uint32_t& L,
+            const vector<ttdb_tran>& trans);
+    static incidence of_shareds(const uint32_t& S,
+            const vector<ttdb_tran>& trans);
+
+    /// the number of rows, i.e., states
+    inline size_t rows() const {
+        return in_offs.size() == 0 ? 0 : in_offs.size() - 1;
+    }
+
+    /// the number of nonzero entries
+    inline size_t nnz() const {
+        return in_ids.size() + out_ids.size();
+    }
+
+    /// the transitions entering state v, i.e., the +1 entries of row v
+    inline array_view<uint32_t> in(const size_t& v) const {
+        return array_view<uint32_t>(in_ids.begin() + in_offs[v],
+                in_offs[v + 1] - in_offs[v]);
+    }
+
+    /// the transitions leaving state v, i.e., the -1 entries of row v
+    inline array_view<uint32_t> out(const size_t& v) const {
+        return array_view<uint32_t>(out_ids.begin() + out_offs[v],
+                out_offs[v + 1] - out_offs[v]);
+    }
+
+    /// the raw CSR arrays, e.g., to hand the matrix to another solver
+    inline const array_view<uint64_t>& get_in_offsets() const {
+        return in_offs;
+    }
+
+    inline const array_view<uint32_t>& get_in_ids() const {
+        return in_ids;
+    }
+
+    inline const array_view<uint64_t>& get_out_offsets() const {
+        return out_offs;
+    }
+
+    inline const array_view<uint32_t>& get_out_ids() const {
+        return out_ids;
+    }
+
+private:
+    /// the storage if the matrix owns its arrays; empty if it is a view
+    vector<uint64_t> offs_store[2];
+    vector<uint32_t> ids_store[2];
+
+    array_view<uint64_t> in_offs;
+    array_view<uint32_t> in_ids;
+    array_view<uint64_t> out_offs;
+    array_view<uint32_t> out_ids;
+
+    /// key(t, v) returns true and sets v if transition t is incident to v
+    typedef bool (*key_fn)(const ttdb_tran& t, uint32_t& v);
+
+    static incidence build(const uint32_t& n, const vector<ttdb_tran>& trans,
+            const key_fn& in_key, const key_fn& out_key);
+    static void build_half(const uint32_t& n, const vector<ttdb_tran>& trans,
+            const key_fn& key, vector<uint64_t>& offs, vector<uint32_t>& ids);
+    static void validate(const array_view<uint64_t>& offs,
+            const array_view<uint32_t>& ids, const uint64_t& n_trans);
+};
+
+} /* namespace sura */
+
+#endif /* INCIDENCE_HH_ */
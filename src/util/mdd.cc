@@ -0,0 +1,501 @@
+/**
+ * @name mdd.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "mdd.hh"
+
+namespace sura {
+
+const mdd_forest::node mdd_forest::EMPTY;
+const mdd_forest::node mdd_forest::FULL;
+const uint32_t mdd_saturation::NONE;
+
+/**
+ * @brief constructor
+ * @param domains: domains[k] is the domain size of level k, k = 1 ... K;
+ *        domains[0] is ignored
+ */
+mdd_forest::mdd_forest(const vector<uint32_t>& domains) :
+        domains(domains), nodes(), pool(), unique(1024, 0), mask(
+                1023), union_cache() {
+    if (domains.empty())
+        throw ural_rt_err("mdd_forest: no level");
+    this->domains[0] = 0;
+    nodes.push_back(node_info { 0, 0 }); /// EMPTY
+    nodes.push_back(node_info { 0, 0 }); /// FULL
+}
+
+mdd_forest::~mdd_forest() {
+}
+
+/**
+ * @brief the hash of a node by its level and children
+ * @param k
+ * @param c
+ * @return uint64_t
+ */
+uint64_t mdd_forest::hash(const uint32_t& k, const node* c) const {
+    uint64_t h = k * 0x9e3779b97f4a7c15ull;
+    for (uint32_t i = 0; i < domains[k]; ++i) {
+        h = (h ^ c[i]) * 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+/**
+ * @brief the unique node at level k with children c
+ * @param k
+ * @param c: domain(k) children at level k - 1
+ * @return node, EMPTY if all children are EMPTY
+ */
+mdd_forest::node mdd_forest::make(const uint32_t& k, const node* c) {
+    const uint32_t d = domains[k];
+    uint32_t i = 0;
+    while (i < d && c[i] == EMPTY)
+        ++i;
+    if (i == d)
+        return EMPTY;
+
+    size_t j = this->hash(k, c) & mask;
+    for (; unique[j] != 0; j = (j + 1) & mask) {
+        const node p = unique[j];
+        if (nodes[p].level == k
+                && std::memcmp(this->children(p), c, d * sizeof(node)) == 0)
+            return p;
+    }
+    if (nodes.size() >= std::numeric_limits<node>::max()
+            || pool.size() + d >= std::numeric_limits<uint32_t>::max())
+        throw ural_rt_err("mdd_forest: too many nodes");
+    const node p = nodes.size();
+    nodes.push_back(node_info { k, uint32_t(pool.size()) });
+    pool.insert(pool.end(), c, c + d);
+    unique[j] = p;
+    if (nodes.size() > unique.size() / 2)
+        this->grow();
+    return p;
+}
+
+/**
+ * @brief double the unique table and reinsert all nodes
+ */
+void mdd_forest::grow() {
+    vector<node> old(unique.size() * 2, 0);
+    old.swap(unique);
+    mask = unique.size() - 1;
+    for (auto it = old.begin(); it != old.end(); ++it) {
+        if (*it == 0)
+            continue;
+        size_t j = this->hash(nodes[*it].level, this->children(*it)) & mask;
+        while (unique[j] != 0)
+            j = (j + 1) & mask;
+        unique[j] = *it;
+    }
+}
+
+/**
+ * @brief the union of two nodes at the same level. The levels are walked
+ *        with an explicit stack, as a forest may be deeper than the call
+ *        stack allows.
+ * @param a
+ * @param b
+ * @return node
+ */
+mdd_forest::node mdd_forest::unite(const node& a, const node& b) {
+    /// the union of a and b if it is known without descending
+    auto lookup = [&](const node& x, const node& y, node& r) {
+        if (x == EMPTY || x == y)
+            r = y;
+        else if (y == EMPTY)
+            r = x;
+        else {
+            auto ifind = union_cache.find(union_key(x, y));
+            if (ifind == union_cache.end())
+                return false;
+            r = ifind->second;
+        }
+        return true;
+    };
+    node r;
+    if (lookup(a, b, r))
+        return r;
+
+    /// a pending union: the children of a, united with those of b so far
+    struct frame {
+        node a, b;
+        uint32_t i;
+        vector<node> c;
+    };
+    vector<frame> worklist;
+    worklist.push_back(frame { a, b, 0, vector<node>(this->children(a),
+            this->children(a) + domains[nodes[a].level]) });
+    while (true) {
+        frame& f = worklist.back();
+        if (f.i < f.c.size()) {
+            const node x = f.c[f.i], y = this->children(f.b)[f.i];
+            if (lookup(x, y, r)) {
+                f.c[f.i++] = r;
+            } else {
+                vector<node> c(this->children(x),
+                        this->children(x) + domains[nodes[x].level]);
+                worklist.push_back(frame { x, y, 0, std::move(c) });
+            }
+            continue;
+        }
+        r = this->make(nodes[f.a].level, f.c.data());
+        union_cache.emplace(union_key(f.a, f.b), r);
+        worklist.pop_back();
+        if (worklist.empty())
+            return r;
+        frame& g = worklist.back();
+        g.c[g.i++] = r;
+    }
+}
+
+/**
+ * @brief the set of one element
+ * @param values: values[k] is the value of x_k, k = 1 ... K
+ * @return node
+ */
+mdd_forest::node mdd_forest::path(const vector<uint32_t>& values) {
+    node p = FULL;
+    for (uint32_t k = 1; k <= this->levels(); ++k) {
+        if (values[k] >= domains[k])
+            throw ural_rt_err("mdd_forest: value out of domain");
+        vector<node> c(domains[k], EMPTY);
+        c[values[k]] = p;
+        p = this->make(k, c.data());
+    }
+    return p;
+}
+
+/**
+ * @brief pick an element of p within the given ranges. The least values are
+ *        preferred from the top level down.
+ * @param p
+ * @param ranges: ranges[k] bounds the value of x_k inclusively
+ * @param values: the element, values[k] is the value of x_k
+ * @return bool: false if there is no such element
+ */
+bool mdd_forest::pick(const node& p,
+        const vector<pair<uint32_t, uint32_t>>& ranges,
+        vector<uint32_t>& values) const {
+    /// nonempty[q]: 0 unknown, 1 no element in the ranges, 2 some
+    vector<char> nonempty(nodes.size(), 0);
+    nonempty[EMPTY] = 1, nonempty[FULL] = 2;
+    /// whether q has an element in the ranges, walked with an explicit
+    /// stack of nodes and their next child
+    auto has = [&](const node& q) {
+        stack<pair<node, uint32_t>> worklist;
+        if (nonempty[q] == 0) {
+            nonempty[q] = 1;
+            worklist.emplace(q, ranges[nodes[q].level].first);
+        }
+        while (!worklist.empty()) {
+            auto& f = worklist.top();
+            const uint32_t k = nodes[f.first].level;
+            if (f.second > ranges[k].second || f.second >= domains[k]) {
+                worklist.pop(); /// no element
+                continue;
+            }
+            const node c = this->children(f.first)[f.second];
+            if (nonempty[c] == 0) {
+                nonempty[c] = 1;
+                worklist.emplace(c, ranges[nodes[c].level].first);
+            } else if (nonempty[c] == 2) {
+                nonempty[f.first] = 2;
+                worklist.pop();
+            } else {
+                ++f.second;
+            }
+        }
+        return nonempty[q] == 2;
+    };
+    if (!has(p))
+        return false;
+
+    values.assign(this->levels() + 1, 0);
+    for (node q = p; q != FULL;) {
+        const uint32_t k = nodes[q].level;
+        uint32_t i = ranges[k].first;
+        while (!has(this->children(q)[i]))
+            ++i;
+        values[k] = i;
+        q = this->children(q)[i];
+    }
+    return true;
+}
+
+/**
+ * @brief the number of elements of p
+ * @param p
+ * @return double
+ */
+double mdd_forest::count(const node& p) const {
+    std::unordered_map<node, double> memo;
+    memo.emplace(EMPTY, 0), memo.emplace(FULL, 1);
+    /// a node is counted once all its children are, in post-order
+    stack<pair<node, bool>> worklist;
+    worklist.emplace(p, false);
+    while (!worklist.empty()) {
+        const node q = worklist.top().first;
+        const uint32_t d = domains[nodes[q].level];
+        if (worklist.top().second) {
+            worklist.pop();
+            double c = 0;
+            for (uint32_t i = 0; i < d; ++i)
+                c += memo[this->children(q)[i]];
+            memo.emplace(q, c);
+            continue;
+        }
+        if (memo.count(q) != 0) {
+            worklist.pop();
+            continue;
+        }
+        worklist.top().second = true;
+        for (uint32_t i = 0; i < d; ++i)
+            if (memo.count(this->children(q)[i]) == 0)
+                worklist.emplace(this->children(q)[i], false);
+    }
+    return memo[p];
+}
+
+/**
+ * @brief the number of nonterminal nodes reachable from p
+ * @param p
+ * @return size_t
+ */
+size_t mdd_forest::size(const node& p) const {
+    vector<bool> visited(nodes.size(), false);
+    stack<node> worklist;
+    worklist.push(p);
+    size_t n = 0;
+    while (!worklist.empty()) {
+        const node q = worklist.top();
+        worklist.pop();
+        if (q == EMPTY || q == FULL || visited[q])
+            continue;
+        visited[q] = true, ++n;
+        for (uint32_t i = 0; i < domains[nodes[q].level]; ++i)
+            worklist.push(this->children(q)[i]);
+    }
+    return n;
+}
+
+/**
+ * @brief constructor
+ * @param forest: the forest of all nodes it creates
+ */
+mdd_saturation::mdd_saturation(mdd_forest& forest) :
+        forest(forest), events(), by_top(
+                forest.levels() + 1), saturate_cache(), fire_cache() {
+}
+
+mdd_saturation::~mdd_saturation() {
+}
+
+/**
+ * @brief add an event
+ * @param event: its local functions, at most one per level
+ */
+void mdd_saturation::add(vector<mdd_local> event) {
+    if (event.empty())
+        return;
+    std::sort(event.begin(), event.end(),
+            [](const mdd_local& a, const mdd_local& b) {
+                return a.level > b.level;
+            });
+    for (auto it = event.begin(); it != event.end(); ++it)
+        if (it->level == 0 || it->level > forest.levels())
+            throw ural_rt_err("mdd_saturation: level out of range");
+    by_top[event.front().level].push_back(events.size());
+    events.emplace_back(std::move(event));
+}
+
+/**
+ * @brief the least superset of p closed under all events
+ * @param p: a node at the top level
+ * @return node
+ */
+mdd_saturation::node mdd_saturation::saturate(const node& p) {
+    return this->run(forest.levels(), p, NONE, 0);
+}
+
+/**
+ * @brief the result of saturate or fire if it is known without descending
+ * @param k: the level of p
+ * @param p
+ * @param e: the event to fire, NONE to saturate
+ * @param i: the first local function of e at level k or below
+ * @param r: the result
+ * @return bool
+ */
+bool mdd_saturation::lookup(const uint32_t& k, const node& p,
+        const uint32_t& e, const uint32_t& i, node& r) const {
+    if (e == NONE ?
+            k == 0 || p == mdd_forest::EMPTY :
+            p == mdd_forest::EMPTY || i == events[e].size()) {
+        r = p; /// the identity below an event is saturated already
+        return true;
+    }
+    if (e == NONE) {
+        auto ifind = saturate_cache.find(p);
+        if (ifind == saturate_cache.end())
+            return false;
+        r = ifind->second;
+    } else {
+        auto ifind = fire_cache.find((uint64_t(e) << 32) | p);
+        if (ifind == fire_cache.end())
+            return false;
+        r = ifind->second;
+    }
+    return true;
+}
+
+/**
+ * @brief saturate a node at level k if e is NONE, otherwise the saturated
+ *        image of a saturated node under the event e.
+ *
+ *        Saturating p saturates its children, and the image of p under e
+ *        is the image of its children under the local functions of e below
+ *        level k. Both then fire the events of level k on the new children
+ *        until none adds anything. A call descends one level, so the calls
+ *        pending at a time are kept in an explicit stack instead of the
+ *        call stack, which a forest may be deeper than.
+ * @param k: the level of p
+ * @param p
+ * @param e: the event, or NONE
+ * @param i: the first local function of e at level k or below
+ * @return node
+ */
+mdd_saturation::node mdd_saturation::run(const uint32_t& k, const node& p,
+        const uint32_t& e, const uint32_t& i) {
+    node r;
+    if (this->lookup(k, p, e, i, r))
+        return r;
+
+    vector<frame> worklist;
+    worklist.push_back(this->call(k, p, e, i));
+    while (true) {
+        frame& f = worklist.back();
+        /// the next pending call of f, and the arguments of it
+        uint32_t _p = 0, _e = NONE, _i = 0;
+        bool is_call = false;
+        if (!f.is_closing) {
+            /// the children of f, on the values v of x_k
+            const uint32_t last = f.e == NONE || !f.is_local ?
+                    f.q.size() - 1 :
+                    std::min(events[f.e][f.i].hi, uint32_t(f.q.size() - 1));
+            if (f.v <= last) {
+                _p = f.c[f.v], _e = f.e, _i = f.i + f.is_local;
+                is_call = true;
+            } else {
+                f.is_closing = true;
+                f.ie = 0, f.j = this->first(f.k, 0);
+            }
+        }
+        if (f.is_closing) {
+            /// fire the events of level k on the children of f
+            while (!is_call) {
+                if (f.ie == by_top[f.k].size()) {
+                    if (!f.is_changed)
+                        break;
+                    f.is_changed = false;
+                    f.ie = 0, f.j = this->first(f.k, 0);
+                    continue;
+                }
+                const mdd_local& t = events[by_top[f.k][f.ie]].front();
+                if (f.j > t.hi || f.j >= f.q.size()) {
+                    ++f.ie, f.j = this->first(f.k, f.ie);
+                } else if (f.q[f.j] == mdd_forest::EMPTY) {
+                    ++f.j;
+                } else {
+                    _p = f.q[f.j], _e = by_top[f.k][f.ie], _i = 1;
+                    is_call = true;
+                }
+            }
+        }
+
+        if (is_call) {
+            if (this->lookup(f.k - 1, _p, _e, _i, r))
+                this->accept(f, r);
+            else /// f is invalid from here
+                worklist.push_back(this->call(f.k - 1, _p, _e, _i));
+            continue;
+        }
+
+        r = forest.make(f.k, f.q.data());
+        if (f.e == NONE)
+            saturate_cache.emplace(f.p, r);
+        else
+            fire_cache.emplace((uint64_t(f.e) << 32) | f.p, r);
+        worklist.pop_back();
+        if (worklist.empty())
+            return r;
+        this->accept(worklist.back(), r);
+    }
+}
+
+/**
+ * @brief the frame of a pending call of run
+ * @param k
+ * @param p
+ * @param e
+ * @param i
+ * @return frame
+ */
+mdd_saturation::frame mdd_saturation::call(const uint32_t& k, const node& p,
+        const uint32_t& e, const uint32_t& i) const {
+    frame f;
+    f.k = k, f.p = p, f.e = e, f.i = i;
+    f.is_local = e != NONE && events[e][i].level == k;
+    f.c.assign(forest.children(p), forest.children(p) + forest.domain(k));
+    if (e == NONE)
+        f.q = f.c;
+    else
+        f.q.assign(forest.domain(k), mdd_forest::EMPTY);
+    f.v = f.is_local ? events[e][i].lo : 0;
+    f.is_closing = false, f.is_changed = false;
+    f.ie = 0, f.j = 0;
+    return f;
+}
+
+/**
+ * @brief pass the result r of the pending call of f to f
+ * @param f
+ * @param r
+ */
+void mdd_saturation::accept(frame& f, const node& r) {
+    if (!f.is_closing) {
+        if (f.is_local) { /// x_k moves from v to v + delta
+            const uint32_t w = f.v + events[f.e][f.i].delta;
+            f.q[w] = forest.unite(f.q[w], r);
+        } else {
+            f.q[f.v] = r;
+        }
+        ++f.v;
+        return;
+    }
+    if (r != mdd_forest::EMPTY) {
+        const uint32_t w = f.j + events[by_top[f.k][f.ie]].front().delta;
+        const node u = forest.unite(f.q[w], r);
+        if (u != f.q[w])
+            f.q[w] = u, f.is_changed = true;
+    }
+    ++f.j;
+}
+
+/**
+ * @brief the least value on which the ie-th event of level k fires
+ * @param k
+ * @param ie
+ * @return uint32_t: 0 if there is no such event
+ */
+uint32_t mdd_saturation::first(const uint32_t& k, const size_t& ie) const {
+    return ie < by_top[k].size() ? events[by_top[k][ie]].front().lo : 0;
+}
+
+} /* namespace sura */
@@ -0,0 +1,166 @@
+/**
+ * @name mdd.hh
+ *
+ * @brief multi-valued decision diagrams and saturation-based reachability
+ *        for the symbolic explicit-thread search
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef MDD_HH_
+#define MDD_HH_
+
+#include <cstdint>
+#include <cstring>
+
+#include "heads.hh"
+
+namespace sura {
+
+/**
+ * @brief a forest of quasi-reduced MDDs over variables x_K ... x_1, where
+ *        x_k ranges over 0 ... domain(k) - 1 and sits at level k. A node at
+ *        level k has one child at level k - 1 per value of x_k; the terminal
+ *        FULL is the only node at level 0, and EMPTY stands for the empty
+ *        set at every level. Nodes are hash-consed in a unique table, so
+ *        equal sets are equal nodes. Nodes are never freed: the forest lives
+ *        as long as one search.
+ */
+class mdd_forest {
+public:
+    typedef uint32_t node;
+
+    static const node EMPTY = 0;
+    static const node FULL = 1;
+
+    mdd_forest(const vector<uint32_t>& domains);
+    ~mdd_forest();
+
+    /// the number of variables K
+    inline uint32_t levels() const {
+        return domains.size() - 1;
+    }
+
+    inline uint32_t domain(const uint32_t& k) const {
+        return domains[k];
+    }
+
+    inline uint32_t level(const node& p) const {
+        return nodes[p].level;
+    }
+
+    inline const node* children(const node& p) const {
+        return pool.data() + nodes[p].offset;
+    }
+
+    /// the number of nodes ever created, i.e., the peak as nothing is freed
+    inline size_t size() const {
+        return nodes.size();
+    }
+
+    node make(const uint32_t& k, const node* c);
+    node unite(const node& a, const node& b);
+    node path(const vector<uint32_t>& values);
+
+    bool pick(const node& p, const vector<pair<uint32_t, uint32_t>>& ranges,
+            vector<uint32_t>& values) const;
+    double count(const node& p) const;
+    size_t size(const node& p) const;
+
+private:
+    struct node_info {
+        uint32_t level;
+        uint32_t offset; /// of its children in pool
+    };
+
+    vector<uint32_t> domains; /// domains[0] is unused
+    vector<node_info> nodes;
+    vector<node> pool;
+
+    vector<node> unique; /// open addressing over node ids, 0 if empty
+    size_t mask;
+    std::unordered_map<uint64_t, node> union_cache;
+
+    uint64_t hash(const uint32_t& k, const node* c) const;
+    void grow();
+
+    static inline uint64_t union_key(const node& a, const node& b) {
+        return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+    }
+};
+
+/**
+ * @brief a local function of an event on level k: values lo ... hi of x_k
+ *        map to x_k + delta, and the others disable the event
+ */
+struct mdd_local {
+    uint32_t level;
+    uint32_t lo;
+    uint32_t hi;
+    int32_t delta;
+};
+
+/**
+ * @brief the saturation algorithm of Ciardo et al. over events in Kronecker
+ *        form: an event is a conjunction of local functions, the identity on
+ *        the levels it does not list. An event belongs to its top level, and
+ *        a node is saturated once it is closed under all events at or below
+ *        its level. Nodes are saturated bottom-up, so firing an event only
+ *        ever produces saturated nodes. Both recurse one level at a time,
+ *        and run keeps the pending calls in an explicit stack.
+ */
+class mdd_saturation {
+public:
+    typedef mdd_forest::node node;
+
+    mdd_saturation(mdd_forest& forest);
+    ~mdd_saturation();
+
+    void add(vector<mdd_local> event);
+    node saturate(const node& p);
+
+    /// the number of events
+    inline size_t size() const {
+        return events.size();
+    }
+
+private:
+    mdd_forest& forest;
+    vector<vector<mdd_local>> events; /// local functions by descending level
+    vector<vector<uint32_t>> by_top;  /// the events of each top level
+
+    std::unordered_map<node, node> saturate_cache;
+    std::unordered_map<uint64_t, node> fire_cache;
+
+    /// the event of a call that saturates
+    static const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    /// a pending call of run on p at level k
+    struct frame {
+        uint32_t k;
+        node p;
+        uint32_t e, i;
+        bool is_local;     /// whether e has a local function at level k
+        vector<node> c;    /// the children of p
+        vector<node> q;    /// the children of the result so far
+        uint32_t v;        /// the next child to descend into
+        bool is_closing;   /// whether the events of level k are fired on q
+        bool is_changed;   /// whether the last pass over them changed q
+        size_t ie;         /// the next event of level k
+        uint32_t j;        /// the next value it fires on
+    };
+
+    node run(const uint32_t& k, const node& p, const uint32_t& e,
+            const uint32_t& i);
+    bool lookup(const uint32_t& k, const node& p, const uint32_t& e,
+            const uint32_t& i, node& r) const;
+    frame call(const uint32_t& k, const node& p, const uint32_t& e,
+            const uint32_t& i) const;
+    void accept(frame& f, const node& r);
+    uint32_t first(const uint32_t& k, const size_t& ie) const;
+};
+
+} /* namespace sura */
+
+#endif /* MDD_HH_ */
@@ -0,0 +1,43 @@
+/**
+ * @name packed.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "packed.hh"
+
+namespace sura {
+
+/**
+ * @brief the layout of packed global states over the current S and L
+ * @param bits : the counter width
+ * @param extra: the number of counters after those of the local states
+ */
+packed_layout::packed_layout(const unsigned& bits, const size_t& extra) :
+        bits(bits), base(0), counters(size_t(thread_state::L) + extra), words(
+                0) {
+    while ((uint64_t(1) << base) < thread_state::S)
+        ++base;
+    base = (base + bits - 1) / bits * bits;
+    words = (base + counters * bits + 63) / 64;
+}
+
+/**
+ * @brief the narrowest counter width that holds the given number of threads
+ * @param bound: the maximum number of threads
+ * @return unsigned
+ */
+unsigned packed_layout::counter_bits(const uint64_t& bound) {
+    if (bound < (1u << 4))
+        return 4;
+    if (bound < (1u << 8))
+        return 8;
+    if (bound < (1u << 16))
+        return 16;
+    if (bound < (uint64_t(1) << 32))
+        return 32;
+    throw ural_rt_err("packed_layout: too many threads");
+}
+
+} /* namespace sura */
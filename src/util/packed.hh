@@ -0,0 +1,762 @@
+/**
+ * @name packed.hh
+ *
+ * @brief bit-packed fixed-width global states for the explicit-state
+ *        search, specialized by the width of counters
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef PACKED_HH_
+#define PACKED_HH_
+
+#include <cstdint>
+
+#include "visited.hh"
+#include "simd.hh"
+
+namespace sura {
+
+/**
+ * @brief the layout of a packed global state <s|c_0 ... c_{L-1}>: an array
+ *        of 64-bit words holding the shared state s in the lowest bits of
+ *        the first word, then one B-bit counter c_l per local state l. The
+ *        shared state field is rounded up to a multiple of B and B divides
+ *        64, so no counter straddles two words. A search may append extra
+ *        counters c_L, ... of its own after those of the local states.
+ */
+class packed_layout {
+public:
+    packed_layout(const unsigned& bits, const size_t& extra = 0);
+
+    static unsigned counter_bits(const uint64_t& bound);
+
+    unsigned bits;   /// the counter width B: 4, 8, 16 or 32
+    unsigned base;   /// the offset of c_0 in bits, i.e., the shared state width
+    size_t counters; /// the number of counters, L and the extra ones
+    size_t words;    /// the number of words per state
+};
+
+/**
+ * @brief the operations on packed global states with B-bit counters. The
+ *        callers guarantee that no counter overflows, i.e., that the number
+ *        of threads stays below 2^B.
+ */
+template<unsigned B>
+class packed {
+public:
+    static const uint64_t MASK = (uint64_t(1) << B) - 1;
+
+    static inline shared_state share(const uint64_t* w,
+            const packed_layout& lay) {
+        return w[0] & ((uint64_t(1) << lay.base) - 1);
+    }
+
+    static inline void set_share(uint64_t* w, const packed_layout& lay,
+            const shared_state& s) {
+        w[0] = (w[0] & ~((uint64_t(1) << lay.base) - 1)) | s;
+    }
+
+    static inline uint64_t get(const uint64_t* w, const packed_layout& lay,
+            const local_state& l) {
+        const size_t b = lay.base + size_t(l) * B;
+        return (w[b >> 6] >> (b & 63)) & MASK;
+    }
+
+    static inline void set(uint64_t* w, const packed_layout& lay,
+            const local_state& l, const uint64_t& c) {
+        const size_t b = lay.base + size_t(l) * B;
+        w[b >> 6] = (w[b >> 6] & ~(MASK << (b & 63))) | (c << (b & 63));
+    }
+
+    static inline void inc(uint64_t* w, const packed_layout& lay,
+            const local_state& l) {
+        const size_t b = lay.base + size_t(l) * B;
+        w[b >> 6] += uint64_t(1) << (b & 63);
+    }
+
+    static inline void dec(uint64_t* w, const packed_layout& lay,
+            const local_state& l) {
+        const size_t b = lay.base + size_t(l) * B;
+        w[b >> 6] -= uint64_t(1) << (b & 63);
+    }
+
+    /**
+     * @brief spread a bitset of local states over the counter fields: the
+     *        field of local state l is all ones iff bit l is set. The AND of
+     *        a packed state with it keeps the counters of those local states.
+     * @param bits: bit l % 64 of word l / 64 stands for local state l
+     * @param lay
+     * @param w   : lay.words words, the shared state field is cleared
+     */
+    static void spread(const uint64_t* bits, const packed_layout& lay,
+            uint64_t* w) {
+        const uint64_t ones = MASK;
+        std::memset(w, 0, lay.words * sizeof(uint64_t));
+        for (size_t i = 0; i < (size_t(thread_state::L) + 63) / 64; ++i)
+            for (uint64_t x = bits[i]; x != 0; x &= x - 1)
+                set(w, lay, i * 64 + __builtin_ctzll(x), ones);
+    }
+
+    /**
+     * @brief visit the occupied local states in ascending order, skipping
+     *        zero words at once
+     * @param w
+     * @param lay
+     * @param k   : the number of words
+     * @param visit: a callback visit(l, c) returning false to stop
+     */
+    template<typename F>
+    static inline void for_each(const uint64_t* w, const packed_layout& lay,
+            const size_t& k, F visit) {
+        for (size_t i = 0; i < k; ++i) {
+            uint64_t x = w[i];
+            if (i == 0) /// skip the shared state
+                x &= ~((uint64_t(1) << lay.base) - 1);
+            while (x != 0) {
+                const unsigned f = (__builtin_ctzll(x) / B) * B;
+                const local_state l = (i * 64 + f - lay.base) / B;
+                if (!visit(l, (x >> f) & MASK))
+                    return;
+                x &= ~(MASK << f);
+            }
+        }
+    }
+
+    /**
+     * @brief print in the format of global_state
+     * @param out
+     * @param w
+     * @param lay
+     * @return ostream
+     */
+    static ostream& to_stream(ostream& out, const uint64_t* w,
+            const packed_layout& lay) {
+        out << "<" << share(w, lay) << "|";
+        for_each(w, lay, lay.words,
+                [&out](const local_state& l, const uint64_t& c) {
+                    out << "(" << l << "," << c << ")";
+                    return true;
+                });
+        out << ">";
+        return out;
+    }
+};
+
+/**
+ * @brief a sequence of global states in a sparse form that does not depend
+ *        on the counter width: the shared state, the number m of occupied
+ *        local states, then m pairs of a local state and its counter. It
+ *        carries the states of a search over to a search whose states are
+ *        packed with wider counters.
+ */
+class sparse_states {
+public:
+    sparse_states() :
+            data(), n(0) {
+    }
+
+    ~sparse_states() {
+    }
+
+    /**
+     * @brief append a packed state
+     * @param w
+     * @param lay: the layout of w
+     */
+    template<unsigned B>
+    void append(const uint64_t* w, const packed_layout& lay) {
+        data.push_back(packed<B>::share(w, lay));
+        const size_t head = data.size();
+        data.push_back(0);
+        vector<uint32_t>& d = data;
+        packed<B>::for_each(w, lay, lay.words,
+                [&d](const local_state& l, const uint64_t& c) {
+                    d.push_back(l);
+                    d.push_back(c);
+                    return true;
+                });
+        data[head] = (data.size() - head - 1) / 2;
+        ++n;
+    }
+
+    /**
+     * @brief pack the state starting at a position
+     * @param pos: the position, advanced to the next state
+     * @param w  : lay.words words
+     * @param lay: a layout whose counters hold those of the state
+     */
+    template<unsigned B>
+    void load(size_t& pos, uint64_t* w, const packed_layout& lay) const {
+        std::memset(w, 0, lay.words * sizeof(uint64_t));
+        packed<B>::set_share(w, lay, data[pos]);
+        const size_t end = pos + 2 + 2 * size_t(data[pos + 1]);
+        for (pos += 2; pos < end; pos += 2)
+            packed<B>::set(w, lay, data[pos], data[pos + 1]);
+    }
+
+    /// the end position of the states
+    inline size_t end() const {
+        return data.size();
+    }
+
+    inline size_t size() const {
+        return n;
+    }
+
+    inline void clear() {
+        vector<uint32_t>().swap(data);
+        n = 0;
+    }
+
+    inline void swap(sparse_states& other) {
+        data.swap(other.data);
+        std::swap(n, other.n);
+    }
+
+private:
+    vector<uint32_t> data;
+    size_t n;
+};
+
+/**
+ * @brief the visited packed global states with K words each, or with a
+ *        number of words fixed at construction if K == 0. It follows
+ *        visited_set: dense ids, an open-addressing table of tagged ids,
+ *        and records in an arena, here in blocks of fixed-size records so
+ *        that an id maps to its record without a pointer per state.
+ */
+template<unsigned K>
+class packed_set {
+public:
+    typedef uint32_t id;
+
+    packed_set(const packed_layout& lay, const bool& huge_pages = false) :
+            k(K ? K : lay.words), store(huge_pages), blocks(), n(0), slots(1024,
+                    0), mask(1023), n_lookups(0), n_probes(0), max_probes(0) {
+    }
+
+    ~packed_set() {
+    }
+
+    /**
+     * @brief the hash of a packed state
+     * @param w
+     * @return uint64_t
+     */
+    inline uint64_t hash(const uint64_t* w) const {
+        uint64_t h = zobrist::mix(w[0] ^ 0x9e3779b97f4a7c15ull);
+        for (size_t i = 1; i < this->words(); ++i)
+            h = zobrist::mix(h ^ w[i]);
+        return h;
+    }
+
+    /**
+     * @brief insert a packed state unless it is visited already
+     * @param w
+     * @return pair<id, bool>
+     *         first : the id of w
+     *         second: true if w is new
+     */
+    inline pair<id, bool> insert(const uint64_t* w) {
+        const uint64_t h = this->hash(w);
+        const uint64_t tag = h & 0xffffffff00000000ull;
+        size_t i = h & mask, p = 1;
+        for (; slots[i] != 0; i = (i + 1) & mask, ++p) {
+            if ((slots[i] & 0xffffffff00000000ull) == tag) {
+                const id j = (slots[i] & 0xffffffffull) - 1;
+                if (this->equal((*this)[j], w)) {
+                    this->count_probes(p);
+                    return std::make_pair(j, false);
+                }
+            }
+        }
+        this->count_probes(p);
+
+        if (n >= std::numeric_limits<id>::max() - 1)
+            throw ural_rt_err("packed_set: too many states");
+        const id j = n++;
+        if ((j & (BLOCK - 1)) == 0)
+            blocks.emplace_back(reinterpret_cast<uint64_t*>(store.allocate(
+                    BLOCK * this->words() * sizeof(uint64_t), 64)));
+        std::memcpy(blocks.back() + (j & (BLOCK - 1)) * this->words(), w,
+                this->words() * sizeof(uint64_t));
+        slots[i] = tag | (uint64_t(j) + 1);
+        if (n > slots.size() / 2)
+            this->grow();
+        return std::make_pair(j, true);
+    }
+
+    inline const uint64_t* operator[](const id& i) const {
+        return blocks[i >> BLOCK_BITS] + (i & (BLOCK - 1)) * this->words();
+    }
+
+    /**
+     * @brief copy a visited state to w
+     * @param i
+     * @param w
+     */
+    inline void load(const id& i, uint64_t* w) const {
+        std::memcpy(w, (*this)[i], this->words() * sizeof(uint64_t));
+    }
+
+    inline size_t words() const {
+        return K ? K : k;
+    }
+
+    inline size_t size() const {
+        return n;
+    }
+
+    inline double load_factor() const {
+        return double(n) / slots.size();
+    }
+
+    inline double mean_probe_length() const {
+        return n_lookups == 0 ? 0 : double(n_probes) / n_lookups;
+    }
+
+    inline size_t max_probe_length() const {
+        return max_probes;
+    }
+
+    ostream& print_stat(ostream& out = cout) const {
+        out << "visited: " << this->size() << " states, " << slots.size()
+                << " slots, load factor " << this->load_factor()
+                << ", probe length " << this->mean_probe_length()
+                << " (mean) " << this->max_probe_length() << " (max), "
+                << n * this->words() * sizeof(uint64_t) / 1024
+                << " KiB of states";
+        return out;
+    }
+
+private:
+    enum {
+        BLOCK_BITS = 16, BLOCK = 1 << BLOCK_BITS
+    };
+
+    size_t k;
+    arena store;
+    vector<uint64_t*> blocks; /// BLOCK records each
+    size_t n;
+
+    vector<uint64_t> slots; /// (hash tag << 32) | (id + 1), 0 if empty
+    size_t mask;
+
+    size_t n_lookups;
+    size_t n_probes;
+    size_t max_probes;
+
+    inline bool equal(const uint64_t* a, const uint64_t* b) const {
+        for (size_t i = 0; i < this->words(); ++i)
+            if (a[i] != b[i])
+                return false;
+        return true;
+    }
+
+    inline void count_probes(const size_t& p) {
+        ++n_lookups, n_probes += p;
+        if (max_probes < p)
+            max_probes = p;
+    }
+
+    /// double the number of slots and reinsert all ids
+    void grow() {
+        vector<uint64_t> old(slots.size() * 2, 0);
+        old.swap(slots);
+        mask = slots.size() - 1;
+        for (auto it = old.begin(); it != old.end(); ++it) {
+            if (*it == 0)
+                continue;
+            const id j = (*it & 0xffffffffull) - 1;
+            size_t i = this->hash((*this)[j]) & mask;
+            while (slots[i] != 0)
+                i = (i + 1) & mask;
+            slots[i] = *it;
+        }
+    }
+};
+
+/**
+ * @brief the visited packed global states with B-bit counters, compressed
+ *        to byte strings: the shared state, then for each occupied local
+ *        state the gap to the previous one and its counter minus 1, all as
+ *        LEB128 varints, behind a varint length. The encoding is canonical,
+ *        so states are probed in compressed form and only decoded when they
+ *        are expanded. A state takes a few bytes per occupied local state
+ *        regardless of L and B.
+ *
+ *        Records are packed into slabs and never straddle two, so the id of
+ *        a state is its position: the slab index above SLAB_BITS bits and
+ *        the offset below. Ids fit in 40 bits, and the table holds them
+ *        tagged with the upper 24 bits of their hashes.
+ */
+template<unsigned B>
+class varint_set {
+public:
+    typedef uint64_t id;
+
+    varint_set(const packed_layout& lay, const bool& huge_pages = false) :
+            lay(lay), store(huge_pages), slabs(), pos(SLAB), n(0), bytes(0), enc(), slots(
+                    1024, 0), mask(1023), n_lookups(0), n_probes(0), max_probes(
+                    0) {
+    }
+
+    ~varint_set() {
+    }
+
+    /**
+     * @brief insert a packed state unless it is visited already
+     * @param w
+     * @return pair<id, bool>
+     *         first : the id of w
+     *         second: true if w is new
+     */
+    inline pair<id, bool> insert(const uint64_t* w) {
+        this->encode(w);
+        const uint64_t h = hash(enc.data(), enc.size());
+        const uint64_t tag = h & TAG_MASK;
+        size_t i = h & mask, p = 1;
+        for (; slots[i] != 0; i = (i + 1) & mask, ++p) {
+            if ((slots[i] & TAG_MASK) == tag) {
+                const id j = (slots[i] & ~TAG_MASK) - 1;
+                size_t len;
+                const char* q = body((*this)[j], len);
+                if (len == enc.size()
+                        && std::memcmp(q, enc.data(), len) == 0) {
+                    this->count_probes(p);
+                    return std::make_pair(j, false);
+                }
+            }
+        }
+        this->count_probes(p);
+
+        /// store the length and the body in the current slab
+        char len[10];
+        const size_t l = put(len, enc.size()) - len;
+        if (pos + l + enc.size() > SLAB) {
+            if (slabs.size() >= (size_t(1) << (40 - SLAB_BITS)))
+                throw ural_rt_err("varint_set: too many states");
+            slabs.emplace_back(store.allocate(SLAB, 64));
+            pos = 0;
+        }
+        const id j = (id(slabs.size() - 1) << SLAB_BITS) | pos;
+        std::memcpy(slabs.back() + pos, len, l);
+        std::memcpy(slabs.back() + pos + l, enc.data(), enc.size());
+        pos += l + enc.size();
+        ++n, bytes += l + enc.size();
+        slots[i] = tag | (j + 1);
+        if (n > slots.size() / 2)
+            this->grow();
+        return std::make_pair(j, true);
+    }
+
+    /**
+     * @brief decode a visited state to w
+     * @param i
+     * @param w: lay.words words
+     */
+    inline void load(const id& i, uint64_t* w) const {
+        size_t len;
+        const char* p = body((*this)[i], len);
+        const char* end = p + len;
+        std::memset(w, 0, lay.words * sizeof(uint64_t));
+        uint64_t x;
+        p = get(p, x);
+        packed<B>::set_share(w, lay, x);
+        uint64_t l = 0, c;
+        for (bool first = true; p != end; first = false) {
+            p = get(p, x);
+            p = get(p, c);
+            l += first ? x : x + 1;
+            packed<B>::set(w, lay, l, c + 1);
+        }
+    }
+
+    inline size_t words() const {
+        return lay.words;
+    }
+
+    inline size_t size() const {
+        return n;
+    }
+
+    inline double load_factor() const {
+        return double(n) / slots.size();
+    }
+
+    inline double mean_probe_length() const {
+        return n_lookups == 0 ? 0 : double(n_probes) / n_lookups;
+    }
+
+    inline size_t max_probe_length() const {
+        return max_probes;
+    }
+
+    ostream& print_stat(ostream& out = cout) const {
+        out << "visited: " << this->size() << " states, " << slots.size()
+                << " slots, load factor " << this->load_factor()
+                << ", probe length " << this->mean_probe_length()
+                << " (mean) " << this->max_probe_length() << " (max), "
+                << bytes / 1024 << " KiB of states ("
+                << (n == 0 ? 0 : double(bytes) / n) << " bytes per state)";
+        return out;
+    }
+
+private:
+    enum {
+        SLAB_BITS = 24, SLAB = 1 << SLAB_BITS
+    };
+    static const uint64_t TAG_MASK = 0xffffff0000000000ull;
+
+    const packed_layout lay;
+    arena store;
+    vector<char*> slabs;
+    size_t pos; /// the end of the last slab
+    size_t n;
+    size_t bytes;
+    string enc; /// the encoding of the state being probed
+
+    vector<uint64_t> slots; /// (hash tag << 40) | (id + 1), 0 if empty
+    size_t mask;
+
+    size_t n_lookups;
+    size_t n_probes;
+    size_t max_probes;
+
+    inline const char* operator[](const id& i) const {
+        return slabs[i >> SLAB_BITS] + (i & (SLAB - 1));
+    }
+
+    /// write x as a LEB128 varint and return the end
+    static inline char* put(char* p, uint64_t x) {
+        for (; x >= 0x80; x >>= 7)
+            *p++ = char(x | 0x80);
+        *p++ = char(x);
+        return p;
+    }
+
+    /// read a LEB128 varint into x and return the end
+    static inline const char* get(const char* p, uint64_t& x) {
+        x = 0;
+        for (unsigned s = 0;; s += 7) {
+            const uint8_t b = *p++;
+            x |= uint64_t(b & 0x7f) << s;
+            if (b < 0x80)
+                return p;
+        }
+    }
+
+    /// the body of a record and its length
+    static inline const char* body(const char* p, size_t& len) {
+        uint64_t x;
+        p = get(p, x);
+        len = x;
+        return p;
+    }
+
+    static inline void append(string& s, const uint64_t& x) {
+        char buf[10];
+        s.append(buf, put(buf, x) - buf);
+    }
+
+    /// encode w into enc
+    inline void encode(const uint64_t* w) {
+        enc.clear();
+        append(enc, packed<B>::share(w, lay));
+        long prev = -1;
+        string& e = enc;
+        packed<B>::for_each(w, lay, lay.words,
+                [&e, &prev](const local_state& l, const uint64_t& c) {
+                    append(e, prev < 0 ? l : l - prev - 1);
+                    append(e, c - 1);
+                    prev = l;
+                    return true;
+                });
+    }
+
+    /// hash a byte string, 8 bytes at a time
+    static inline uint64_t hash(const char* p, const size_t& len) {
+        uint64_t h = zobrist::mix(len ^ 0x9e3779b97f4a7c15ull);
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8) {
+            uint64_t x;
+            std::memcpy(&x, p + i, 8);
+            h = zobrist::mix(h ^ x);
+        }
+        if (i < len) {
+            uint64_t x = 0;
+            std::memcpy(&x, p + i, len - i);
+            h = zobrist::mix(h ^ x);
+        }
+        return h;
+    }
+
+    inline void count_probes(const size_t& p) {
+        ++n_lookups, n_probes += p;
+        if (max_probes < p)
+            max_probes = p;
+    }
+
+    /// double the number of slots and reinsert all ids
+    void grow() {
+        vector<uint64_t> old(slots.size() * 2, 0);
+        old.swap(slots);
+        mask = slots.size() - 1;
+        for (auto it = old.begin(); it != old.end(); ++it) {
+            if (*it == 0)
+                continue;
+            size_t len;
+            const char* q = body((*this)[(*it & ~TAG_MASK) - 1], len);
+            size_t i = hash(q, len) & mask;
+            while (slots[i] != 0)
+                i = (i + 1) & mask;
+            slots[i] = *it;
+        }
+    }
+};
+
+/**
+ * @brief the maximal packed global states visited so far with B-bit
+ *        counters, for coverability: a state is covered by another with the
+ *        same shared state if none of its counters is greater, and a
+ *        covered state reaches nothing its coverer cannot cover. A new state
+ *        covered by a kept one is dropped, and the kept states it covers are
+ *        evicted.
+ *
+ *        The kept states are indexed by shared state, and each index holds
+ *        their words contiguously, so that it is scanned linearly. Counters
+ *        are compared many at a time by simd::covers, so the layout must
+ *        leave the top bit of every counter free. A search whose states
+ *        carry a budget, e.g., of spawns, keeps it in an extra counter, so
+ *        that a state covers another only if its budget is not smaller.
+ *
+ *        Every state kept at some point gets a dense id and is stored until
+ *        the set is destroyed, so the worklist can refer to it.
+ */
+template<unsigned B>
+class packed_antichain {
+public:
+    typedef uint32_t id;
+
+    packed_antichain(const packed_layout& lay) :
+            lay(lay), k(lay.words), H(lay.words, 0), t(lay.words), store(), evicted(), chains(
+                    thread_state::S), n_kept(0), n_dropped(0), n_evicted(0), max_width(
+                    0) {
+        for (size_t l = 0; l < lay.counters; ++l) {
+            const size_t b = lay.base + l * B + B - 1;
+            H[b >> 6] |= uint64_t(1) << (b & 63);
+        }
+    }
+
+    ~packed_antichain() {
+    }
+
+    /**
+     * @brief insert a packed state unless a kept state covers it
+     * @param w: a state whose counters are below 2^(B - 1)
+     * @return pair<id, bool>
+     *         first : the id of w, if kept
+     *         second: true if w is kept
+     */
+    pair<id, bool> insert(const uint64_t* w) {
+        std::memcpy(t.data(), w, k * sizeof(uint64_t));
+        t[0] &= ~share_mask(); /// compare the counters only
+        chain& c = chains[packed<B>::share(w, lay)];
+        for (size_t i = 0; i < c.ids.size(); ++i)
+            if (this->covers(c.words.data() + i * k, t.data())) {
+                ++n_dropped;
+                return std::make_pair(0, false);
+            }
+        /// evict the kept states covered by w
+        for (size_t i = 0; i < c.ids.size();) {
+            if (this->covers(t.data(), c.words.data() + i * k)) {
+                evicted[c.ids[i]] = true;
+                ++n_evicted, --n_kept;
+                const size_t last = c.ids.size() - 1;
+                std::memcpy(c.words.data() + i * k,
+                        c.words.data() + last * k, k * sizeof(uint64_t));
+                c.words.resize(last * k);
+                c.ids[i] = c.ids[last];
+                c.ids.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        if (evicted.size() >= std::numeric_limits<id>::max())
+            throw ural_rt_err("packed_antichain: too many states");
+        const id j = evicted.size();
+        store.insert(store.end(), w, w + k);
+        evicted.push_back(false);
+        c.words.insert(c.words.end(), t.begin(), t.end());
+        c.ids.push_back(j);
+        ++n_kept;
+        if (max_width < c.ids.size())
+            max_width = c.ids.size();
+        return std::make_pair(j, true);
+    }
+
+    /// whether a state is evicted, i.e., covered by a state kept later
+    inline bool is_evicted(const id& i) const {
+        return evicted[i];
+    }
+
+    /**
+     * @brief copy a state to w
+     * @param i
+     * @param w
+     */
+    inline void load(const id& i, uint64_t* w) const {
+        std::memcpy(w, store.data() + size_t(i) * k, k * sizeof(uint64_t));
+    }
+
+    inline size_t words() const {
+        return k;
+    }
+
+    /// the number of kept states
+    inline size_t size() const {
+        return n_kept;
+    }
+
+    ostream& print_stat(ostream& out = cout) const {
+        out << "antichain: " << n_kept << " states kept, " << n_evicted
+                << " evicted, " << n_dropped << " dropped, width "
+                << max_width << " (max), "
+                << store.size() * sizeof(uint64_t) / 1024 << " KiB of states";
+        return out;
+    }
+
+private:
+    /// the kept states of a shared state, with the shared state cleared
+    struct chain {
+        vector<uint64_t> words;
+        vector<id> ids;
+    };
+
+    const packed_layout lay;
+    const size_t k;
+    vector<uint64_t> H;        /// the top bits of all counters
+    vector<uint64_t> t;        /// the state being inserted, shared cleared
+    vector<uint64_t> store;    /// the states, k words each, by id
+    vector<bool> evicted;      /// by id
+    vector<chain> chains;      /// by shared state
+    size_t n_kept;
+    size_t n_dropped;
+    size_t n_evicted;
+    size_t max_width;
+
+    inline uint64_t share_mask() const {
+        return (uint64_t(1) << lay.base) - 1;
+    }
+
+    /// whether u covers t: both have their shared states cleared
+    inline bool covers(const uint64_t* u, const uint64_t* t) const {
+        return simd::covers(u, t, H.data(), k);
+    }
+};
+
+} /* namespace sura */
+
+#endif /* PACKED_HH_ */
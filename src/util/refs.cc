@@ -31,6 +31,16 @@ bool refs::OPT_PRINT_DOT = false;
 bool refs::OPT_PRINT_ADJ = false;
 bool refs::OPT_PRINT_CMD = false;
 bool refs::OPT_PRINT_ALL = false;
+bool refs::OPT_PRINT_STAT = false;
+
+bool refs::OPT_HUGE_PAGES = false;
+bool refs::OPT_COMPRESS = false;
+bool refs::OPT_ANTICHAIN = false;
+bool refs::OPT_POR = false;
+bool refs::OPT_SLEEP_SETS = false;
+string refs::OPT_ENGINE = "fws"; /// the engine deciding what the TSE cannot
+uint refs::OPT_THREADS = 1; /// the workers of the explicit search
+uint refs::OPT_REFINEMENTS = 16; /// the CEGAR rounds before km decides
 
 ushort refs::TARGET_THR_NUM = 1; /// default is 1
 
@@ -40,8 +50,7 @@ string refs::S_FINAL_TS = "";
 thread_state refs::INITL_TS;
 thread_state refs::FINAL_TS;
 
-adj_list refs::original_TTD;
-adj_list refs::spawntra_TTD;
+adj_csr refs::original_TTD;
 
 bool refs::is_exists_SPAWN = false;
 
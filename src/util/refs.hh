@@ -8,7 +8,7 @@
 #ifndef REFS_HH_
 #define REFS_HH_
 
-#include "state.hh"
+#include "csr.hh"
 
 namespace sura {
 
@@ -31,6 +31,15 @@ public:
 	static bool OPT_COMPLETE;
 	static bool OPT_BACKWARD;
 	static bool OPT_SHARED;
+	static bool OPT_PRINT_STAT;
+	static bool OPT_HUGE_PAGES;
+	static bool OPT_COMPRESS;
+	static bool OPT_ANTICHAIN;
+	static bool OPT_POR;
+	static bool OPT_SLEEP_SETS;
+	static string OPT_ENGINE;
+	static uint OPT_THREADS;
+	static uint OPT_REFINEMENTS;
 
 	static ushort TARGET_THR_NUM;
 
@@ -39,8 +48,7 @@ public:
 
 	static string S_FINAL_TS;
 
-	static adj_list original_TTD;
-	static adj_list spawntra_TTD;
+	static adj_csr original_TTD; /// spawn transitions are tagged inline
 
 	static bool is_exists_SPAWN;
 
@@ -0,0 +1,143 @@
+/**
+ * @name simd.hh
+ *
+ * @brief vectorized kernels on raw memory. The widest instruction set the
+ *        compiler targets is used (AVX2, SSE2), with a word-wise fallback.
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef SIMD_HH_
+#define SIMD_HH_
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+/**
+ * @brief find the first byte where two buffers differ
+ * @param a
+ * @param b
+ * @param n: the length of both buffers in bytes
+ * @return the index of the first differing byte, or n if a == b
+ */
+inline size_t mismatch(const void* a, const void* b, const size_t& n) {
+    const char* p = static_cast<const char*>(a);
+    const char* q = static_cast<const char*>(b);
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 32 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(p + i));
+        const __m256i y = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(q + i));
+        const uint32_t m = ~uint32_t(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (m != 0)
+            return i + __builtin_ctz(m);
+    }
+#endif
+#ifdef __SSE2__
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(p + i));
+        const __m128i y = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(q + i));
+        const uint32_t m = ~uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)))
+                & 0xffff;
+        if (m != 0)
+            return i + __builtin_ctz(m);
+    }
+#endif
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, p + i, 8);
+        std::memcpy(&y, q + i, 8);
+        if (x != y)
+            return i + __builtin_ctzll(x ^ y) / 8;
+    }
+#endif
+    for (; i < n; ++i)
+        if (p[i] != q[i])
+            return i;
+    return n;
+}
+
+/**
+ * @brief compare two arrays of unsigned integers lexicographically
+ * @param a
+ * @param b
+ * @param n: the length of both arrays
+ * @return -1 if a < b, 0 if a == b, 1 if a > b
+ */
+template<typename T>
+inline short compare(const T* a, const T* b, const size_t& n) {
+    const size_t i = mismatch(a, b, n * sizeof(T)) / sizeof(T);
+    if (i == n)
+        return 0;
+    return a[i] < b[i] ? -1 : 1;
+}
+
+/**
+ * @brief whether every counter packed in u is at least the counter at the
+ *        same place in t. H has the top bit of every counter set, and these
+ *        bits are clear in u and t, so no subtraction borrows across a
+ *        counter and u covers t iff ((u | H) - t) & H == H in every word.
+ * @param u
+ * @param t
+ * @param H
+ * @param k: the number of words of u, t and H
+ * @return bool
+ */
+inline bool covers(const uint64_t* u, const uint64_t* t, const uint64_t* H,
+        const size_t& k) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= k; i += 4) {
+        const __m256i h = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(H + i));
+        const __m256i x = _mm256_and_si256(
+                _mm256_sub_epi64(
+                        _mm256_or_si256(
+                                _mm256_loadu_si256(
+                                        reinterpret_cast<const __m256i*>(u
+                                                + i)), h),
+                        _mm256_loadu_si256(
+                                reinterpret_cast<const __m256i*>(t + i))), h);
+        if (uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, h)))
+                != 0xffffffffu)
+            return false;
+    }
+#endif
+#ifdef __SSE2__
+    for (; i + 2 <= k; i += 2) {
+        const __m128i h = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(H + i));
+        const __m128i x = _mm_and_si128(
+                _mm_sub_epi64(
+                        _mm_or_si128(
+                                _mm_loadu_si128(
+                                        reinterpret_cast<const __m128i*>(u
+                                                + i)), h),
+                        _mm_loadu_si128(
+                                reinterpret_cast<const __m128i*>(t + i))), h);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, h)) != 0xffff)
+            return false;
+    }
+#endif
+    for (; i < k; ++i)
+        if ((((u[i] | H[i]) - t[i]) & H[i]) != H[i])
+            return false;
+    return true;
+}
+
+} /* namespace simd */
+
+#endif /* SIMD_HH_ */
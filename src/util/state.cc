@@ -11,4 +11,176 @@
 namespace sura {
 size_s thread_state::S; /// the size of shared state
 size_l thread_state::L; /// the size of local  state
+
+const size_t Locals::INLINE_BYTES;
+const size_t Locals::PAIR_BYTES;
+
+/**
+ * @brief constructor with an uninitialized buffer
+ * @param dense: the form
+ * @param cap  : the capacity, L if dense
+ */
+Locals::Locals(const bool& dense, const uint32_t& cap) :
+        n(0), cap(cap), dense(dense), on_heap(false), mem() {
+    const size_t bytes = dense ? cap * sizeof(size_p) : cap * PAIR_BYTES;
+    if (bytes > INLINE_BYTES) {
+        mem.heap = new char[bytes];
+        on_heap = true;
+    }
+    if (dense)
+        std::memset(data(), 0, bytes);
+}
+
+/**
+ * @brief copy constructor: the copy is compact, i.e., its capacity is the
+ *        number of occupied local states
+ * @param z
+ */
+Locals::Locals(const Locals& z) :
+        Locals(z.dense, z.dense ? z.cap : z.n) {
+    n = z.n;
+    if (dense) {
+        std::memcpy(counts(), z.counts(), cap * sizeof(size_p));
+    } else {
+        std::memcpy(locals(), z.locals(), n * sizeof(local_state));
+        std::memcpy(counts(), z.counts(), n * sizeof(size_p));
+    }
+}
+
+/**
+ * @brief copy assignment
+ * @param z
+ */
+Locals& Locals::operator=(const Locals& z) {
+    if (this == &z)
+        return *this;
+    if (dense != z.dense || (!dense && cap < z.n) || (dense && cap != z.cap)) {
+        *this = Locals(z);
+        return *this;
+    }
+    /// reuse the buffer
+    n = z.n;
+    if (dense) {
+        std::memcpy(counts(), z.counts(), cap * sizeof(size_p));
+    } else {
+        std::memcpy(locals(), z.locals(), n * sizeof(local_state));
+        std::memcpy(counts(), z.counts(), n * sizeof(size_p));
+    }
+    return *this;
+}
+
+/**
+ * @brief overwrite this with the counter encoded at p. The buffer is reused
+ *        if it is large enough, so decoding into a scratch counter over and
+ *        over allocates nothing in the steady state.
+ * @param p: see encode
+ */
+void Locals::decode(const char* p) {
+    uint32_t _n;
+    std::memcpy(&_n, p, sizeof(uint32_t));
+    p += sizeof(uint32_t);
+    const bool _dense = is_dense_size(_n);
+    if (dense != _dense || (!dense && cap < _n)
+            || (dense && cap != thread_state::L))
+        *this = Locals(_dense, _dense ? uint32_t(thread_state::L) : _n);
+    n = _n;
+    if (dense) {
+        std::memcpy(counts(), p, cap * sizeof(size_p));
+    } else {
+        std::memcpy(locals(), p, n * sizeof(local_state));
+        std::memcpy(counts(), p + n * sizeof(local_state), n * sizeof(size_p));
+    }
+}
+
+/**
+ * @brief insert local state l with counter c at position i of the sparse
+ *        form; switch to the dense form if it becomes smaller
+ * @param i
+ * @param l
+ * @param c
+ */
+void Locals::insert(const uint32_t& i, const local_state& l,
+        const size_p& c) {
+    if (is_dense_size(n + 1)) {
+        this->to_dense();
+        counts()[l] = c;
+        ++n;
+        return;
+    }
+    if (n == cap) { /// grow
+        Locals z(false, std::max(2 * cap, 4u));
+        std::memcpy(z.locals(), locals(), n * sizeof(local_state));
+        std::memcpy(z.counts(), counts(), n * sizeof(size_p));
+        z.n = n;
+        *this = std::move(z);
+    }
+    local_state* p = locals();
+    size_p* q = counts();
+    std::memmove(p + i + 1, p + i, (n - i) * sizeof(local_state));
+    std::memmove(q + i + 1, q + i, (n - i) * sizeof(size_p));
+    p[i] = l, q[i] = c;
+    ++n;
+}
+
+/**
+ * @brief remove position i of the sparse form
+ * @param i
+ */
+void Locals::erase(const uint32_t& i) {
+    local_state* p = locals();
+    size_p* q = counts();
+    std::memmove(p + i, p + i + 1, (n - i - 1) * sizeof(local_state));
+    std::memmove(q + i, q + i + 1, (n - i - 1) * sizeof(size_p));
+    --n;
+}
+
+/**
+ * @brief replace the local state at position i of the sparse form by l,
+ *        which is unoccupied, and keep the order. The counter moves along.
+ * @param i
+ * @param l
+ */
+void Locals::replace(const uint32_t& i, const local_state& l) {
+    local_state* p = locals();
+    size_p* q = counts();
+    const size_p c = q[i];
+    const uint32_t j = this->find(l);
+    if (j > i) { /// shift (i, j) left
+        std::memmove(p + i, p + i + 1, (j - i - 1) * sizeof(local_state));
+        std::memmove(q + i, q + i + 1, (j - i - 1) * sizeof(size_p));
+        p[j - 1] = l, q[j - 1] = c;
+    } else { /// shift [j, i) right
+        std::memmove(p + j + 1, p + j, (i - j) * sizeof(local_state));
+        std::memmove(q + j + 1, q + j, (i - j) * sizeof(size_p));
+        p[j] = l, q[j] = c;
+    }
+}
+
+/**
+ * @brief convert the sparse form to the dense form
+ */
+void Locals::to_dense() {
+    Locals z(true, thread_state::L);
+    for (uint32_t i = 0; i < n; ++i)
+        z.counts()[locals()[i]] = counts()[i];
+    z.n = n;
+    *this = std::move(z);
+}
+
+/**
+ * @brief convert the dense form to the sparse form
+ */
+void Locals::to_sparse() {
+    Locals z(false, n);
+    uint32_t i = 0;
+    for (uint32_t l = 0; l < cap; ++l) {
+        if (counts()[l] > 0) {
+            z.locals()[i] = l;
+            z.counts()[i] = counts()[l];
+            ++i;
+        }
+    }
+    z.n = n;
+    *this = std::move(z);
+}
 } /* namespace SURA */
@@ -9,9 +9,24 @@
 #define STATE_HH_
 
 #include "algs.hh"
+#include "simd.hh"
 
 namespace sura {
 
+#ifdef __LARGE_MODEL__
+/// define local state: 32-bit for abstractions beyond 65535 states
+typedef unsigned int local_state;
+/// define the size of local states
+typedef unsigned int size_l;
+
+/// define shared state
+typedef unsigned int shared_state;
+/// define size of shared states
+typedef unsigned int size_s;
+
+/// define the thread state id, i.e., share * L + local
+typedef unsigned long id_thread_state;
+#else
 /// define local state
 typedef unsigned short local_state;
 /// define the size of local states
@@ -22,12 +37,13 @@ typedef unsigned short shared_state;
 /// define size of shared states
 typedef unsigned short size_s;
 
+/// define the thread state id, i.e., share * L + local
+typedef unsigned int id_thread_state;
+#endif
+
 /// define the counter of thread state
 typedef unsigned short size_p;
 
-/// define the thread state id
-typedef unsigned int id_thread_state;
-
 /// class thread state
 class thread_state {
 public:
@@ -37,6 +53,7 @@ public:
     inline thread_state();
     inline thread_state(const thread_state& t);
     inline thread_state(const shared_state& share, const local_state& local);
+    inline explicit thread_state(const id_thread_state& id);
     ~thread_state() {
     }
 
@@ -50,6 +67,16 @@ public:
         return share;
     }
 
+    /**
+     * @brief the dense id share * L + local: thread states ordered by
+     *        operator < have consecutive ids, so it can index flat arrays
+     *        of size S * L
+     * @return id_thread_state
+     */
+    inline id_thread_state get_id() const {
+        return id_thread_state(share) * L + local;
+    }
+
 private:
     shared_state share;
     local_state local;
@@ -82,6 +109,15 @@ inline thread_state::thread_state(const shared_state& share,
     __SAFE_ASSERT__(share < S && local < L);
 }
 
+/**
+ * @brief constructor with a thread state id
+ * @param id: share * L + local
+ */
+inline thread_state::thread_state(const id_thread_state& id) :
+        share(id / L), local(id % L) {
+    __SAFE_ASSERT__(share < S);
+}
+
 /**
  * @brief print thread state
  * @param out
@@ -154,7 +190,400 @@ inline bool operator>(const thread_state& t1, const thread_state& t2) {
 }
 
 /// class global state
-typedef map<local_state, size_p> Locals;
+/**
+ * @brief the counters of local states in a global state, i.e., the pairs
+ *        (l, c) such that c > 0 threads reside in local state l. It is a
+ *        flat replacement of map<local_state, size_p> in one of two forms:
+ *        sparse: the occupied local states in ascending order followed by
+ *                their counters, as two parallel arrays;
+ *        dense : one counter per local state.
+ *        The form only depends on the number of occupied local states:
+ *        dense iff it takes no more bytes than sparse. Thus equal counters
+ *        always have equal bytes, and comparisons are plain memory
+ *        comparisons. Buffers up to INLINE_BYTES are stored inline.
+ */
+class Locals {
+public:
+    typedef pair<local_state, size_p> value_type;
+
+    /// iterate over the occupied local states in ascending order
+    class const_iterator {
+    public:
+        inline const_iterator(const Locals* z, const uint32_t& i) :
+                z(z), i(i), cur() {
+            this->load();
+        }
+
+        inline const value_type& operator*() const {
+            return cur;
+        }
+
+        inline const value_type* operator->() const {
+            return &cur;
+        }
+
+        inline const_iterator& operator++() {
+            ++i;
+            this->load();
+            return *this;
+        }
+
+        inline bool operator==(const const_iterator& it) const {
+            return i == it.i;
+        }
+
+        inline bool operator!=(const const_iterator& it) const {
+            return i != it.i;
+        }
+
+    private:
+        const Locals* z;
+        uint32_t i;
+        value_type cur;
+
+        inline void load() {
+            if (z->dense) {
+                const size_p* c = z->counts();
+                while (i < z->cap && c[i] == 0)
+                    ++i;
+                if (i < z->cap)
+                    cur = value_type(i, c[i]);
+            } else if (i < z->n) {
+                cur = value_type(z->locals()[i], z->counts()[i]);
+            }
+        }
+    };
+
+    inline Locals();
+    Locals(const Locals& z);
+    inline Locals(Locals&& z);
+    ~Locals() {
+        if (on_heap)
+            delete[] mem.heap;
+    }
+
+    Locals& operator=(const Locals& z);
+    inline Locals& operator=(Locals&& z);
+
+    inline size_t size() const {
+        return n;
+    }
+
+    inline bool empty() const {
+        return n == 0;
+    }
+
+    inline bool is_dense() const {
+        return dense;
+    }
+
+    inline const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    inline const_iterator end() const {
+        return const_iterator(this, dense ? cap : n);
+    }
+
+    inline size_p get(const local_state& l) const;
+    inline void emplace(const local_state& l, const size_p& c);
+    inline void inc(const local_state& l);
+    inline void dec(const local_state& l);
+    inline void move(const local_state& dec, const local_state& inc);
+
+    inline bool equal(const Locals& z) const;
+    inline short compare(const Locals& z) const;
+
+    inline size_t encoded_size() const;
+    inline char* encode(char* p) const;
+    void decode(const char* p);
+    inline bool equal(const char* p) const;
+
+private:
+    static const size_t INLINE_BYTES = 16;
+    static const size_t PAIR_BYTES = sizeof(local_state) + sizeof(size_p);
+
+    uint32_t n;   /// the number of occupied local states
+    uint32_t cap; /// sparse: the capacity of both arrays; dense: L
+    bool dense;
+    bool on_heap;
+    union {
+        char buf[INLINE_BYTES];
+        char* heap;
+    } mem;
+
+    Locals(const bool& dense, const uint32_t& cap);
+
+    /**
+     * @brief determine the form of n occupied local states
+     * @param n
+     * @return bool
+     */
+    static inline bool is_dense_size(const size_t& n) {
+        return size_t(thread_state::L) * sizeof(size_p)
+                <= std::max(INLINE_BYTES, n * PAIR_BYTES);
+    }
+
+    inline const char* data() const {
+        return on_heap ? mem.heap : mem.buf;
+    }
+
+    inline char* data() {
+        return on_heap ? mem.heap : mem.buf;
+    }
+
+    inline const local_state* locals() const {
+        return reinterpret_cast<const local_state*>(data());
+    }
+
+    inline local_state* locals() {
+        return reinterpret_cast<local_state*>(data());
+    }
+
+    inline const size_p* counts() const {
+        return reinterpret_cast<const size_p*>(
+                dense ? data() : data() + cap * sizeof(local_state));
+    }
+
+    inline size_p* counts() {
+        return reinterpret_cast<size_p*>(
+                dense ? data() : data() + cap * sizeof(local_state));
+    }
+
+    /// the position of l in the sparse form, or where to insert it
+    inline uint32_t find(const local_state& l) const {
+        const local_state* p = this->locals();
+        return std::lower_bound(p, p + n, l) - p;
+    }
+
+    void insert(const uint32_t& i, const local_state& l, const size_p& c);
+    void erase(const uint32_t& i);
+    void replace(const uint32_t& i, const local_state& l);
+    void to_dense();
+    void to_sparse();
+};
+
+/**
+ * @brief default constructor: no thread
+ */
+inline Locals::Locals() :
+        n(0), cap(0), dense(false), on_heap(false), mem() {
+    if (is_dense_size(0)) {
+        dense = true;
+        cap = thread_state::L;
+        std::memset(mem.buf, 0, cap * sizeof(size_p));
+    }
+}
+
+/**
+ * @brief move constructor
+ * @param z
+ */
+inline Locals::Locals(Locals&& z) :
+        n(z.n), cap(z.cap), dense(z.dense), on_heap(z.on_heap), mem(z.mem) {
+    z.n = z.cap = 0;
+    z.dense = z.on_heap = false;
+}
+
+/**
+ * @brief move assignment
+ * @param z
+ */
+inline Locals& Locals::operator=(Locals&& z) {
+    if (this != &z) {
+        if (on_heap)
+            delete[] mem.heap;
+        n = z.n, cap = z.cap, dense = z.dense, on_heap = z.on_heap;
+        mem = z.mem;
+        z.n = z.cap = 0;
+        z.dense = z.on_heap = false;
+    }
+    return *this;
+}
+
+/**
+ * @brief the counter of local state l
+ * @param l
+ * @return size_p
+ */
+inline size_p Locals::get(const local_state& l) const {
+    if (dense)
+        return l < cap ? counts()[l] : 0;
+    const uint32_t i = this->find(l);
+    return i < n && locals()[i] == l ? counts()[i] : 0;
+}
+
+/**
+ * @brief set the counter of local state l to c if l is unoccupied
+ * @param l
+ * @param c
+ */
+inline void Locals::emplace(const local_state& l, const size_p& c) {
+    if (c == 0)
+        return;
+    if (dense) {
+        if (counts()[l] == 0)
+            counts()[l] = c, ++n;
+        return;
+    }
+    const uint32_t i = this->find(l);
+    if (i == n || locals()[i] != l)
+        this->insert(i, l, c);
+}
+
+/**
+ * @brief increment the counter of local state l
+ * @param l
+ */
+inline void Locals::inc(const local_state& l) {
+    __SAFE_ASSERT__(l < thread_state::L);
+    if (dense) {
+        if (counts()[l]++ == 0)
+            ++n;
+        return;
+    }
+    const uint32_t i = this->find(l);
+    if (i < n && locals()[i] == l)
+        ++counts()[i];
+    else
+        this->insert(i, l, 1);
+}
+
+/**
+ * @brief decrement the counter of local state l
+ * @param l
+ */
+inline void Locals::dec(const local_state& l) {
+    if (dense) {
+        if (l >= cap || counts()[l] == 0)
+            throw ural_rt_err("Locals::dec: local state misses");
+        if (--counts()[l] == 0 && !is_dense_size(--n))
+            this->to_sparse();
+        return;
+    }
+    const uint32_t i = this->find(l);
+    if (i == n || locals()[i] != l)
+        throw ural_rt_err("Locals::dec: local state misses");
+    if (--counts()[i] == 0)
+        this->erase(i);
+}
+
+/**
+ * @brief move a thread from local state dec to local state inc, i.e., dec
+ *        and inc in one step. Unlike the two calls, it never changes the
+ *        form or reallocates if the number of occupied local states stays
+ *        the same, so a move and its inverse are cheap to apply in place.
+ * @param dec
+ * @param inc
+ */
+inline void Locals::move(const local_state& dec, const local_state& inc) {
+    if (dec == inc)
+        return;
+    if (dense) {
+        size_p* c = counts();
+        if (dec >= cap || c[dec] == 0)
+            throw ural_rt_err("Locals::dec: local state misses");
+        if (c[inc]++ == 0)
+            ++n;
+        if (--c[dec] == 0 && !is_dense_size(--n))
+            this->to_sparse();
+        return;
+    }
+    const uint32_t i = this->find(dec);
+    if (i == n || locals()[i] != dec)
+        throw ural_rt_err("Locals::dec: local state misses");
+    if (counts()[i] > 1) {
+        --counts()[i];
+        this->inc(inc);
+        return;
+    }
+    const uint32_t j = this->find(inc);
+    if (j < n && locals()[j] == inc) {
+        ++counts()[j];
+        this->erase(i);
+    } else { /// the thread leaves dec empty and enters an empty inc
+        this->replace(i, inc);
+    }
+}
+
+/**
+ * @brief determine if two counters are equal
+ * @param z
+ * @return bool
+ */
+inline bool Locals::equal(const Locals& z) const {
+    if (n != z.n) /// the same n implies the same form
+        return false;
+    if (dense)
+        return simd::compare(counts(), z.counts(), cap) == 0;
+    return simd::compare(locals(), z.locals(), n) == 0
+            && simd::compare(counts(), z.counts(), n) == 0;
+}
+
+/**
+ * @brief a total order on counters: by the number of occupied local states,
+ *        then by the bytes of the representation
+ * @param z
+ * @return -1 if this < z, 0 if this == z, 1 if this > z
+ */
+inline short Locals::compare(const Locals& z) const {
+    if (n != z.n)
+        return n < z.n ? -1 : 1;
+    if (dense)
+        return simd::compare(counts(), z.counts(), cap);
+    const short c = simd::compare(locals(), z.locals(), n);
+    return c != 0 ? c : simd::compare(counts(), z.counts(), n);
+}
+
+/**
+ * @brief the number of bytes of the flat encoding: the number of occupied
+ *        local states as uint32_t, then the arrays of the representation.
+ *        The form is implied by that number, so it is not stored.
+ * @return size_t
+ */
+inline size_t Locals::encoded_size() const {
+    return sizeof(uint32_t)
+            + (dense ? cap * sizeof(size_p) : n * PAIR_BYTES);
+}
+
+/**
+ * @brief write the flat encoding to p, which must be aligned to
+ *        sizeof(uint32_t) and hold encoded_size() bytes
+ * @param p
+ * @return char*: the end of the encoding
+ */
+inline char* Locals::encode(char* p) const {
+    std::memcpy(p, &n, sizeof(uint32_t));
+    p += sizeof(uint32_t);
+    if (dense) {
+        std::memcpy(p, counts(), cap * sizeof(size_p));
+        return p + cap * sizeof(size_p);
+    }
+    std::memcpy(p, locals(), n * sizeof(local_state));
+    p += n * sizeof(local_state);
+    std::memcpy(p, counts(), n * sizeof(size_p));
+    return p + n * sizeof(size_p);
+}
+
+/**
+ * @brief determine if this equals the counter encoded at p
+ * @param p
+ * @return bool
+ */
+inline bool Locals::equal(const char* p) const {
+    uint32_t _n;
+    std::memcpy(&_n, p, sizeof(uint32_t));
+    if (n != _n)
+        return false;
+    p += sizeof(uint32_t);
+    if (dense)
+        return simd::mismatch(counts(), p, cap * sizeof(size_p))
+                == cap * sizeof(size_p);
+    return simd::mismatch(locals(), p, n * sizeof(local_state))
+            == n * sizeof(local_state)
+            && simd::mismatch(counts(), p + n * sizeof(local_state),
+                    n * sizeof(size_p)) == n * sizeof(size_p);
+}
 
 class global_state {
 public:
@@ -276,7 +705,7 @@ inline ostream& operator<<(ostream& out, const global_state& g) {
  */
 inline bool operator<(const global_state& s1, const global_state& s2) {
     if (s1.get_share() == s2.get_share()) {
-        return COMPARE::compare_map(s1.get_locals(), s2.get_locals()) == -1;
+        return s1.get_locals().compare(s2.get_locals()) == -1;
     } else {
         return s1.get_share() < s2.get_share();
     }
@@ -303,18 +732,8 @@ inline bool operator>(const global_state& s1, const global_state& s2) {
  * 		   false: otherwise
  */
 inline bool operator==(const global_state& s1, const global_state& s2) {
-    if (s1.get_share() == s2.get_share()) {
-        if (s1.get_locals().size() == s2.get_locals().size()) {
-            auto is1 = s1.get_locals().begin(), is2 = s2.get_locals().begin();
-            while (is1 != s1.get_locals().end()) {
-                if ((is1->first != is2->first) || (is1->second != is2->second))
-                    return false;
-                is1++, is2++;
-            }
-            return true;
-        }
-    }
-    return false;
+    return s1.get_share() == s2.get_share()
+            && s1.get_locals().equal(s2.get_locals());
 }
 
 /**
@@ -0,0 +1,159 @@
+/**
+ * @name ttdb.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include <cstring>
+
+#include "ttdb.hh"
+#include "incidence.hh"
+
+namespace sura {
+
+const char ttdb::MAGIC[8] = { '\x89', 'T', 'T', 'D', 'B', '\r', '\n', '\x1a' };
+
+/**
+ * @brief constructor: validate a mapped .ttdb buffer. Nothing is copied,
+ *        all accessors return views into the buffer.
+ * @param first: the beginning of buffer
+ * @param last : the end of buffer
+ */
+ttdb::ttdb(const char* first, const char* last) :
+        first(first), header(reinterpret_cast<const ttdb_header*>(first)), index(
+                nullptr) {
+    const uint64_t size = last - first;
+    if (!is_ttdb(first, last) || size < sizeof(ttdb_header))
+        throw ural_rt_err("ttdb: not a .ttdb file");
+    if (header->version != VERSION)
+        throw ural_rt_err(
+                "ttdb: unsupported version " + std::to_string(header->version)
+                        + ", please recompile the .ttd file");
+    if (header->byte_order != 0x01020304)
+        throw ural_rt_err("ttdb: the file is compiled on another byte order");
+    if (header->n_sections < N_SECTIONS
+            || sizeof(ttdb_header) + header->n_sections * sizeof(ttdb_section)
+                    > size)
+        throw ural_rt_err("ttdb: corrupted section index");
+
+    index = reinterpret_cast<const ttdb_section*>(first + sizeof(ttdb_header));
+    for (uint32_t i = 0; i < N_SECTIONS; ++i) {
+        const ttdb_section& sec = index[i];
+        const uint32_t width = i == TRANS ? sizeof(ttdb_tran) :
+                                (i == L_IN_OFF || i == L_OUT_OFF
+                                        || i == S_IN_OFF || i == S_OUT_OFF) ?
+                                        sizeof(uint64_t) : sizeof(uint32_t);
+        if (sec.kind != i || sec.width != width || sec.offset % 8 != 0
+                || sec.offset > size
+                || sec.count > (size - sec.offset) / sec.width)
+            throw ural_rt_err("ttdb: corrupted section " + std::to_string(i));
+    }
+
+    if (index[TRANS].count != header->n_trans
+            || index[L_IN_OFF].count != header->L + 1ul
+            || index[L_OUT_OFF].count != header->L + 1ul
+            || index[S_IN_OFF].count != header->S + 1ul
+            || index[S_OUT_OFF].count != header->S + 1ul)
+        throw ural_rt_err("ttdb: inconsistent header");
+    for (uint32_t i = L_IN_OFF; i < SPAWN_IDS; i += 2)
+        if (get_offsets(section(i))[index[i].count - 1] != index[i + 1].count)
+            throw ural_rt_err("ttdb: inconsistent incidence lists");
+}
+
+ttdb::~ttdb() {
+}
+
+/**
+ * @brief determine if a buffer starts with the .ttdb magic number
+ * @param first
+ * @param last
+ * @return bool
+ */
+bool ttdb::is_ttdb(const char* first, const char* last) {
+    return size_t(last - first) >= sizeof(MAGIC)
+            && std::memcmp(first, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+/**
+ * @brief compile the transitions into a .ttdb file
+ * @param filename    : the name of output file
+ * @param is_self_loop: whether the self-loops are kept in trans
+ * @param trans       : transitions in transition-ID order
+ */
+void ttdb::write(const string& filename, const bool& is_self_loop,
+        const vector<ttdb_tran>& trans) {
+    const uint32_t S = thread_state::S, L = thread_state::L;
+
+    const incidence l_matrix = incidence::of_locals(L, trans);
+    const incidence s_matrix = incidence::of_shareds(S, trans);
+    array_view<uint64_t> offs[N_SECTIONS];
+    array_view<uint32_t> ids[N_SECTIONS];
+    offs[L_IN_OFF] = l_matrix.get_in_offsets();
+    ids[L_IN_IDS] = l_matrix.get_in_ids();
+    offs[L_OUT_OFF] = l_matrix.get_out_offsets();
+    ids[L_OUT_IDS] = l_matrix.get_out_ids();
+    offs[S_IN_OFF] = s_matrix.get_in_offsets();
+    ids[S_IN_IDS] = s_matrix.get_in_ids();
+    offs[S_OUT_OFF] = s_matrix.get_out_offsets();
+    ids[S_OUT_IDS] = s_matrix.get_out_ids();
+
+    vector<uint32_t> spawns;
+    for (size_t id = 0; id < trans.size(); ++id)
+        if (trans[id].flags & ttdb_tran::SPAWN)
+            spawns.emplace_back(id);
+    ids[SPAWN_IDS] = array_view<uint32_t>(spawns.data(), spawns.size());
+    const bool is_spawn = !spawns.empty();
+
+    ttdb_header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byte_order = 0x01020304;
+    header.flags = (is_self_loop ? SELF_LOOP : 0) | (is_spawn ? SPAWN : 0);
+    header.S = S;
+    header.L = L;
+    header.n_sections = N_SECTIONS;
+    header.n_trans = trans.size();
+
+    /// lay out the sections
+    ttdb_section index[N_SECTIONS];
+    const char* data[N_SECTIONS];
+    uint64_t offset = sizeof(header) + sizeof(index);
+    for (uint32_t i = 0; i < N_SECTIONS; ++i) {
+        ttdb_section& sec = index[i];
+        sec.kind = i;
+        sec.offset = offset;
+        if (i == TRANS) {
+            sec.width = sizeof(ttdb_tran);
+            sec.count = trans.size();
+            data[i] = reinterpret_cast<const char*>(trans.data());
+        } else if (i < SPAWN_IDS && (i - L_IN_OFF) % 2 == 0) {
+            sec.width = sizeof(uint64_t);
+            sec.count = offs[i].size();
+            data[i] = reinterpret_cast<const char*>(offs[i].begin());
+        } else {
+            sec.width = sizeof(uint32_t);
+            sec.count = ids[i].size();
+            data[i] = reinterpret_cast<const char*>(ids[i].begin());
+        }
+        offset = (offset + sec.width * sec.count + 7) / 8 * 8;
+    }
+
+    ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out.good())
+        throw ural_rt_err("ttdb: cannot create " + filename);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index), sizeof(index));
+    const char padding[8] = { 0 };
+    uint64_t pos = sizeof(header) + sizeof(index);
+    for (uint32_t i = 0; i < N_SECTIONS; ++i) {
+        out.write(padding, index[i].offset - pos);
+        out.write(data[i], index[i].width * index[i].count);
+        pos = index[i].offset + index[i].width * index[i].count;
+    }
+    if (!out.good())
+        throw ural_rt_err("ttdb: failed to write " + filename);
+}
+
+} /* namespace sura */
@@ -0,0 +1,158 @@
+/**
+ * @name ttdb.hh
+ *
+ * @brief the compiled binary format of thread-state transition diagrams.
+ *        A .ttdb file is laid out as follows, all integers in native byte
+ *        order and every section aligned to 8 bytes:
+ *
+ *        ttdb_header   magic, version, flags, S, L, #transitions, #sections
+ *        ttdb_section  x #sections: the section index
+ *        sections      TRANS     : packed ttdb_tran array in transition-ID
+ *                                  order (self-loops already removed unless
+ *                                  compiled with --self-loop)
+ *                      *_OFF/IDS : incidence lists in CSR form, i.e., the
+ *                                  incoming/outgoing transition IDs of every
+ *                                  local/shared state
+ *                      SPAWN_IDS : IDs of all spawn transitions
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef TTDB_HH_
+#define TTDB_HH_
+
+#include <cstdint>
+
+#include "state.hh"
+
+namespace sura {
+
+/// a read-only view of a contiguous array
+template<typename T>
+class array_view {
+public:
+    inline array_view() :
+            first(nullptr), length(0) {
+    }
+
+    inline array_view(const T* first, const size_t& length) :
+            first(first), length(length) {
+    }
+
+    inline const T* begin() const {
+        return first;
+    }
+
+    inline const T* end() const {
+        return first + length;
+    }
+
+    inline size_t size() const {
+        return length;
+    }
+
+    inline const T& operator[](const size_t& i) const {
+        return first[i];
+    }
+
+private:
+    const T* first;
+    size_t length;
+};
+
+/// a transition record in .ttdb files
+struct ttdb_tran {
+    static const uint32_t SPAWN = 1; /// flag: src +> dst
+
+    uint32_t s1, l1; /// source      thread state
+    uint32_t s2, l2; /// destination thread state
+    uint32_t flags;
+};
+
+/// the fixed-size header of .ttdb files
+struct ttdb_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order; /// 0x01020304 written in native byte order
+    uint32_t flags;
+    uint32_t S;
+    uint32_t L;
+    uint32_t n_sections;
+    uint64_t n_trans;
+};
+
+/// an entry of the section index
+struct ttdb_section {
+    uint32_t kind;
+    uint32_t width;  /// size of one element in bytes
+    uint64_t offset; /// from the beginning of file
+    uint64_t count;  /// number of elements
+};
+
+class ttdb {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint32_t SELF_LOOP = 1; /// header flag: --self-loop
+    static const uint32_t SPAWN = 2;     /// header flag: spawns exist
+
+    enum section {
+        TRANS = 0,
+        L_IN_OFF, L_IN_IDS, L_OUT_OFF, L_OUT_IDS,
+        S_IN_OFF, S_IN_IDS, S_OUT_OFF, S_OUT_IDS,
+        SPAWN_IDS, N_SECTIONS
+    };
+
+    ttdb(const char* first, const char* last);
+    ~ttdb();
+
+    static bool is_ttdb(const char* first, const char* last);
+    static void write(const string& filename, const bool& is_self_loop,
+            const vector<ttdb_tran>& trans);
+
+    inline uint32_t get_S() const {
+        return header->S;
+    }
+
+    inline uint32_t get_L() const {
+        return header->L;
+    }
+
+    inline bool is_self_loop() const {
+        return header->flags & SELF_LOOP;
+    }
+
+    inline bool is_exists_spawn() const {
+        return header->flags & SPAWN;
+    }
+
+    inline array_view<ttdb_tran> get_trans() const {
+        return get<ttdb_tran>(TRANS);
+    }
+
+    inline array_view<uint64_t> get_offsets(const section& kind) const {
+        return get<uint64_t>(kind);
+    }
+
+    inline array_view<uint32_t> get_ids(const section& kind) const {
+        return get<uint32_t>(kind);
+    }
+
+private:
+    static const char MAGIC[8];
+
+    const char* first;
+    const ttdb_header* header;
+    const ttdb_section* index;
+
+    template<typename T>
+    inline array_view<T> get(const section& kind) const {
+        const ttdb_section& sec = index[kind];
+        return array_view<T>(reinterpret_cast<const T*>(first + sec.offset),
+                sec.count);
+    }
+};
+
+} /* namespace sura */
+
+#endif /* TTDB_HH_ */
@@ -5,6 +5,11 @@
  * @author: Peizun Liu
  */
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include "utilities.hh"
 
 namespace sura {
@@ -76,47 +81,95 @@ void util::print_adj_list(
 }
 
 /**
- * @brief remove the comments of .ttd files
- * @param in
- * @param filename
- * @param comment
+ * @brief print all of the transitions in the thread-state transition diagram
+ * @param adj
+ * @param out
  */
-void parser::remove_comments(istream& in, const string& filename,
-        const string& comment) {
-    ofstream out(filename.c_str());
-    remove_comments(in, out, comment);
+void util::print_adj_list(const adj_csr& adj, ostream& out) {
+    out << thread_state::L << " " << thread_state::S << endl;
+    for (id_thread_state v = 0; v < adj.size(); ++v) {
+        const thread_state src(v);
+        const auto& succ = adj.successors(src);
+        for (auto ie = succ.begin(); ie != succ.end(); ++ie)
+            out << src << " -> " << ie->dst << endl;
+    }
 }
 
 /**
- * @brief remove the comments of .ttd files
- * @param in
- * @param out
- * @param comment
+ * @brief parse the header "S L" of a .ttd file and set the sizes of shared
+ *        and local states
+ * @param first     : the beginning of buffer
+ * @param last      : the end of buffer
+ * @param is_partial: whether more input follows the buffer, see parse_ttd
+ * @return the position right after the header, or nullptr if the buffer
+ *         ends before the header is complete and is_partial is set
  */
-void parser::remove_comments(const string& in, string& out,
-        const string& comment) {
-    std::istringstream instream(in);
-    std::ostringstream outstream;
-    remove_comments(instream, outstream, comment);
-    out = outstream.str();
-}
-
-void parser::remove_comments(istream& in, ostream& out, const string& comment) {
-    string line;
-    while (getline(in, line = "")) {
-        const size_t comment_start = line.find(comment);
-        out
-                << (comment_start == string::npos ?
-                        line : line.substr(0, comment_start)) << endl;
+const char* parser::parse_ttd_header(const char* first, const char* last,
+        const bool& is_partial) {
+    const char* p = skip_blanks(first, last);
+    const char* begin = p;
+    const char* q;
+    uint S, L;
+    if (!(q = scan_uint(p, last, S))
+            || !(q = scan_uint(p = skip_blanks(q, last), last, L))) {
+        if (is_partial && p == last)
+            return nullptr;
+        parse_error(begin, last, "illegal header");
     }
+    p = q;
+    if (S > std::numeric_limits<size_s>::max()
+            || L > std::numeric_limits<size_l>::max())
+        parse_error(begin, last, "the number of states exceeds the limit");
+    thread_state::S = S;
+    thread_state::L = L;
+    return p;
 }
 
-bool parser::getline(istream& in, string& line, const char& eol) {
-    char c = 0;
-    while (in.get(c) ? c != eol : false)
-        line += c;
-    return c != 0;
+/**
+ * @brief throw a parse error quoting the offending line
+ * @param p   : the beginning of offending token
+ * @param last: the end of buffer
+ * @param msg : error message
+ */
+void parser::parse_error(const char* p, const char* last, const string& msg) {
+    const char* eol = std::find(p, last, '\n');
+    throw ural_rt_err("parse_ttd: " + msg + ": \"" + string(p, eol) + "\"");
 }
 
 /// end of PARSER
+
+/**
+ * @brief map the whole file into memory read-only
+ * @param filename
+ */
+mapped_file::mapped_file(const string& filename) :
+        fd(-1), data(nullptr), length(0) {
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw ural_rt_err("Input file does not find!");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw ural_rt_err("mapped_file: cannot stat " + filename);
+    }
+
+    length = st.st_size;
+    if (length > 0) {
+        void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw ural_rt_err("mapped_file: cannot map " + filename);
+        }
+        ::madvise(addr, length, MADV_SEQUENTIAL);
+        data = static_cast<char*>(addr);
+    }
+}
+
+mapped_file::~mapped_file() {
+    if (data != nullptr)
+        ::munmap(data, length);
+    if (fd >= 0)
+        ::close(fd);
+}
 } /* namespace SURA */
@@ -28,21 +28,212 @@ public:
     static void print_adj_list(
             const map<thread_state, deque<thread_state> >& adj_list,
             ostream& out = cout);
+    static void print_adj_list(const adj_csr& adj, ostream& out = cout);
+};
+
+/// read-only memory mapping of a whole input file
+class mapped_file {
+public:
+    mapped_file(const string& filename);
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    inline const char* begin() const {
+        return data;
+    }
+
+    inline const char* end() const {
+        return data + length;
+    }
+
+    inline size_t size() const {
+        return length;
+    }
+
+private:
+    int fd;
+    char* data;
+    size_t length;
 };
 
 class parser {
 public:
-    static void remove_comments(istream& in, const string& filename,
-            const string& comment);
-    static void remove_comments(const string& in, string& out,
-            const string& comment);
+    static const char* parse_ttd_header(const char* first, const char* last,
+            const bool& is_partial = false);
+    template<typename F>
+    static const char* parse_ttd(const char* first, const char* last, F emit,
+            const bool& is_partial = false);
+    template<typename F>
+    static void parse_ttd_parallel(const char* first, const char* last,
+            const uint& n_threads, F emit);
 
 private:
-    static void remove_comments(istream& in, ostream& out,
-            const string& comment);
-    static bool getline(istream& in, string& line, const char& eol = '\n');
+    static inline const char* skip_blanks(const char* p, const char* last);
+    static inline const char* scan_uint(const char* p, const char* last,
+            uint& value);
+    static void parse_error(const char* p, const char* last,
+            const string& msg);
 };
 
+/**
+ * @brief skip white spaces and "#"-comments
+ * @param p   : current position
+ * @param last: the end of buffer
+ * @return the position of next token, or last
+ */
+inline const char* parser::skip_blanks(const char* p, const char* last) {
+    while (p != last) {
+        if (*p == '#') {
+            while (p != last && *p != '\n')
+                ++p;
+        } else if (std::isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+/**
+ * @brief scan an unsigned decimal integer
+ * @param p    : the position of first digit
+ * @param last : the end of buffer
+ * @param value: the scanned value
+ * @return the position right after the integer, or nullptr if there
+ *         is no digit at p. Throws ural_rt_err if the integer exceeds the
+ *         maximum of uint.
+ */
+inline const char* parser::scan_uint(const char* p, const char* last,
+        uint& value) {
+    if (p == last || uint(*p - '0') > 9)
+        return nullptr;
+    const char* begin = p;
+    value = 0;
+    do {
+        const uint d = uint(*p - '0');
+        if (value > (std::numeric_limits<uint>::max() - d) / 10)
+            parse_error(begin, last, "integer out of range");
+        value = value * 10 + d;
+        ++p;
+    } while (p != last && uint(*p - '0') <= 9);
+    return p;
+}
+
+/**
+ * @brief parse the transitions "s1 l1 -> s2 l2" and "s1 l1 +> s2 l2" of a
+ *        .ttd file in place, i.e., without copying the buffer. The header
+ *        must have been consumed via parse_ttd_header already.
+ * @param first     : the position right after the header
+ * @param last      : the end of buffer
+ * @param emit      : callback emit(src, dst, is_spawn) for every transition
+ * @param is_partial: whether more input follows the buffer. If so, the
+ *                    buffer must end at a line boundary, and a transition
+ *                    left incomplete at its end is not an error.
+ * @return the beginning of the incomplete transition at the end of buffer,
+ *         or last if there is none
+ */
+template<typename F>
+const char* parser::parse_ttd(const char* first, const char* last, F emit,
+        const bool& is_partial) {
+    const char* p = skip_blanks(first, last);
+    while (p != last) {
+        const char* begin = p;
+        const char* q;
+        uint s1, l1, s2, l2;
+        if (!(q = scan_uint(p, last, s1))
+                || !(q = scan_uint(p = skip_blanks(q, last), last, l1))) {
+            if (is_partial && p == last)
+                return begin;
+            parse_error(begin, last, "illegal thread state");
+        }
+
+        p = skip_blanks(q, last);
+        if (last - p < 2 || (p[0] != '-' && p[0] != '+') || p[1] != '>') {
+            if (is_partial && p == last)
+                return begin;
+            parse_error(begin, last, "illegal transition");
+        }
+        const bool is_spawn = p[0] == '+';
+
+        if (!(q = scan_uint(p = skip_blanks(p + 2, last), last, s2))
+                || !(q = scan_uint(p = skip_blanks(q, last), last, l2))) {
+            if (is_partial && p == last)
+                return begin;
+            parse_error(begin, last, "illegal thread state");
+        }
+
+        if (s1 >= thread_state::S || s2 >= thread_state::S
+                || l1 >= thread_state::L || l2 >= thread_state::L)
+            parse_error(begin, last, "thread state out of range");
+
+        emit(thread_state(s1, l1), thread_state(s2, l2), is_spawn);
+        p = skip_blanks(q, last);
+    }
+    return last;
+}
+
+/**
+ * @brief parse the transitions of a .ttd file with n_threads threads. The
+ *        buffer is split at line boundaries into n_threads chunks, which
+ *        are parsed concurrently into thread-local buffers. The buffers
+ *        are then emitted in file order, so the callback sees exactly the
+ *        same sequence as with parse_ttd.
+ *
+ *        A chunk fails to parse if a transition spans over its end, e.g.,
+ *        "s1 l1 ->" and "s2 l2" on two lines. Since all preceding chunks
+ *        end at transition boundaries then, the remainder of the buffer is
+ *        parsed sequentially from the beginning of the failed chunk.
+ * @param first    : the position right after the header
+ * @param last     : the end of buffer
+ * @param n_threads: the number of threads
+ * @param emit     : callback emit(src, dst, is_spawn) for every transition
+ */
+template<typename F>
+void parser::parse_ttd_parallel(const char* first, const char* last,
+        const uint& n_threads, F emit) {
+    struct parsed {
+        thread_state src, dst;
+        bool is_spawn;
+    };
+
+    vector<const char*> bounds(1, first);
+    for (uint i = 1; i < n_threads; ++i) {
+        const char* p = std::max(bounds.back(),
+                first + (last - first) / n_threads * i);
+        p = std::find(p, last, '\n');
+        bounds.emplace_back(p == last ? last : p + 1);
+    }
+    bounds.emplace_back(last);
+
+    vector<std::future<vector<parsed>>> chunks;
+    for (uint i = 0; i < n_threads; ++i) {
+        chunks.emplace_back(std::async(std::launch::async, [&bounds, i]() {
+            vector<parsed> buf;
+            parse_ttd(bounds[i], bounds[i + 1],
+                    [&buf](const thread_state& src, const thread_state& dst,
+                            const bool& is_spawn) {
+                        buf.emplace_back(parsed {src, dst, is_spawn});
+                    });
+            return buf;
+        }));
+    }
+
+    for (uint i = 0; i < n_threads; ++i) {
+        vector<parsed> buf;
+        try {
+            buf = chunks[i].get();
+        } catch (const ural_rt_err& e) {
+            parse_ttd(bounds[i], last, emit);
+            return;
+        }
+        for (auto it = buf.begin(); it != buf.end(); ++it)
+            emit(it->src, it->dst, it->is_spawn);
+    }
+}
+
 } /* namespace SURA */
 
 #endif /* UTILITIES_HH_ */
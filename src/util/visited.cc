@@ -0,0 +1,109 @@
+/**
+ * @name visited.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "visited.hh"
+
+namespace sura {
+
+/// the initial number of slots, a power of 2
+const size_t visited_set::INITIAL_SLOTS = 1024;
+/// the table doubles once it is fuller than this
+const double visited_set::MAX_LOAD_FACTOR = 0.5;
+
+/**
+ * @brief constructor
+ * @param huge_pages: back the state records by huge pages
+ */
+visited_set::visited_set(const bool& huge_pages) :
+        slots(INITIAL_SLOTS, 0), mask(INITIAL_SLOTS - 1), store(
+                huge_pages), records(), hashes(), n_lookups(0), n_probes(0), max_probes(
+                0) {
+}
+
+visited_set::~visited_set() {
+}
+
+/**
+ * @brief insert a global state unless it is visited already. The state is
+ *        passed in parts and copied only if it is new, so the caller can
+ *        probe a scratch state.
+ * @param s: shared state
+ * @param z: local states
+ * @param h: its Zobrist hash
+ * @return pair<id, bool>
+ *         first : the id of <s|z>
+ *         second: true if <s|z> is new
+ */
+pair<visited_set::id, bool> visited_set::insert(const shared_state& s,
+        const Locals& z, const uint64_t& h) {
+    const uint64_t tag = h & 0xffffffff00000000ull;
+    size_t i = h & mask, n = 1;
+    for (; slots[i] != 0; i = (i + 1) & mask, ++n) {
+        if ((slots[i] & 0xffffffff00000000ull) == tag) {
+            const id j = (slots[i] & 0xffffffffull) - 1;
+            uint32_t share;
+            std::memcpy(&share, records[j], sizeof(uint32_t));
+            if (hashes[j] == h && share == s
+                    && z.equal(records[j] + sizeof(uint32_t))) {
+                ++n_lookups, n_probes += n;
+                max_probes = std::max(max_probes, n);
+                return std::make_pair(j, false);
+            }
+        }
+    }
+    ++n_lookups, n_probes += n;
+    max_probes = std::max(max_probes, n);
+
+    if (records.size() >= std::numeric_limits<id>::max() - 1)
+        throw ural_rt_err("visited_set: too many states");
+    const id j = records.size();
+    const uint32_t share = s;
+    char* p = store.allocate(sizeof(uint32_t) + z.encoded_size(),
+            sizeof(uint32_t));
+    std::memcpy(p, &share, sizeof(uint32_t));
+    z.encode(p + sizeof(uint32_t));
+    records.emplace_back(p);
+    hashes.emplace_back(h);
+    slots[i] = tag | (uint64_t(j) + 1);
+    if (records.size() > MAX_LOAD_FACTOR * slots.size())
+        this->grow();
+    return std::make_pair(j, true);
+}
+
+/**
+ * @brief double the number of slots and reinsert all ids
+ */
+void visited_set::grow() {
+    vector<uint64_t> old(slots.size() * 2, 0);
+    old.swap(slots);
+    mask = slots.size() - 1;
+    for (auto it = old.begin(); it != old.end(); ++it) {
+        if (*it == 0)
+            continue;
+        const id j = (*it & 0xffffffffull) - 1;
+        size_t i = hashes[j] & mask;
+        while (slots[i] != 0)
+            i = (i + 1) & mask;
+        slots[i] = *it;
+    }
+}
+
+/**
+ * @brief print the statistics of the table
+ * @param out
+ * @return ostream
+ */
+ostream& visited_set::print_stat(ostream& out) const {
+    out << "visited: " << this->size() << " states, " << slots.size()
+            << " slots, load factor " << this->load_factor()
+            << ", probe length " << this->mean_probe_length() << " (mean) "
+            << this->max_probe_length() << " (max), "
+            << store.size() / 1024 << " KiB of states";
+    return out;
+}
+
+} /* namespace sura */
@@ -0,0 +1,174 @@
+/**
+ * @name visited.hh
+ *
+ * @brief the set of visited global states of the explicit-state search:
+ *        an open-addressing hash table over Zobrist hashes
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef VISITED_HH_
+#define VISITED_HH_
+
+#include <cstdint>
+
+#include "state.hh"
+#include "arena.hh"
+
+namespace sura {
+
+/**
+ * @brief Zobrist hashing of global states: the hash of <s|(l1,c1)...(lk,ck)>
+ *        is share(s) ^ local(l1, c1) ^ ... ^ local(lk, ck). Firing a
+ *        transition changes one shared state and at most two counters, so
+ *        the hash of a successor is its predecessor's hash xor six keys.
+ *        The keys are derived from the arguments by a mixing function, so
+ *        there is no table to size by the number of threads.
+ */
+class zobrist {
+public:
+    /**
+     * @brief the key of shared state s
+     * @param s
+     * @return uint64_t
+     */
+    static inline uint64_t share(const shared_state& s) {
+        return mix(0x9e3779b97f4a7c15ull ^ s);
+    }
+
+    /**
+     * @brief the key of c threads residing in local state l
+     * @param l
+     * @param c
+     * @return uint64_t, 0 if c == 0
+     */
+    static inline uint64_t local(const local_state& l, const size_p& c) {
+        return c == 0 ? 0 : mix((uint64_t(l) << 32) | c);
+    }
+
+    /**
+     * @brief the hash of a global state from scratch
+     * @param s: shared state
+     * @param z: local states
+     * @return uint64_t
+     */
+    static inline uint64_t hash(const shared_state& s, const Locals& z) {
+        uint64_t h = share(s);
+        for (auto il = z.begin(); il != z.end(); ++il)
+            h ^= local(il->first, il->second);
+        return h;
+    }
+
+    /**
+     * @brief the hash change of moving a thread from local state dec, where
+     *        c_dec threads reside, to local state inc, where c_inc reside
+     * @param dec
+     * @param c_dec
+     * @param inc
+     * @param c_inc
+     * @return uint64_t
+     */
+    static inline uint64_t move(const local_state& dec, const size_p& c_dec,
+            const local_state& inc, const size_p& c_inc) {
+        return local(dec, c_dec) ^ local(dec, c_dec - 1) ^ local(inc, c_inc)
+                ^ local(inc, c_inc + 1);
+    }
+
+    /**
+     * @brief the hash change of adding a thread to local state inc, where
+     *        c_inc threads reside
+     * @param inc
+     * @param c_inc
+     * @return uint64_t
+     */
+    static inline uint64_t spawn(const local_state& inc, const size_p& c_inc) {
+        return local(inc, c_inc) ^ local(inc, c_inc + 1);
+    }
+
+    /// the finalizer of splitmix64
+    static inline uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+};
+
+/**
+ * @brief the visited global states. Every state gets a dense id in the order
+ *        of insertion. The table holds ids tagged with the upper half of
+ *        their hashes and is probed linearly, so a mismatch rarely touches
+ *        the state itself.
+ *
+ *        States are stored as flat records in an arena: the shared state as
+ *        uint32_t followed by the encoding of the counter. All records are
+ *        released together with the set.
+ */
+class visited_set {
+public:
+    typedef uint32_t id;
+
+    visited_set(const bool& huge_pages = false);
+    ~visited_set();
+
+    pair<id, bool> insert(const shared_state& s, const Locals& z,
+            const uint64_t& h);
+
+    /**
+     * @brief decode a visited state into s and z; z's buffer is reused
+     * @param i
+     * @param s
+     * @param z
+     */
+    inline void load(const id& i, shared_state& s, Locals& z) const {
+        uint32_t share;
+        std::memcpy(&share, records[i], sizeof(uint32_t));
+        s = share;
+        z.decode(records[i] + sizeof(uint32_t));
+    }
+
+    inline uint64_t hash(const id& i) const {
+        return hashes[i];
+    }
+
+    inline size_t size() const {
+        return records.size();
+    }
+
+    inline double load_factor() const {
+        return double(records.size()) / slots.size();
+    }
+
+    inline double mean_probe_length() const {
+        return n_lookups == 0 ? 0 : double(n_probes) / n_lookups;
+    }
+
+    inline size_t max_probe_length() const {
+        return max_probes;
+    }
+
+    ostream& print_stat(ostream& out = cout) const;
+
+private:
+    static const size_t INITIAL_SLOTS;
+    static const double MAX_LOAD_FACTOR;
+
+    vector<uint64_t> slots; /// (hash tag << 32) | (id + 1), 0 if empty
+    size_t mask;
+    arena store;
+    vector<const char*> records;
+    vector<uint64_t> hashes;
+
+    size_t n_lookups;
+    size_t n_probes;
+    size_t max_probes;
+
+    void grow();
+};
+
+} /* namespace sura */
+
+#endif /* VISITED_HH_ */
@@ -0,0 +1,251 @@
+/**
+ * @name zstream.cc
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include <cstring>
+
+#ifdef __WITH_ZLIB__
+#include <zlib.h>
+#endif
+#ifdef __WITH_LZMA__
+#include <lzma.h>
+#endif
+#ifdef __WITH_ZSTD__
+#include <zstd.h>
+#endif
+
+#include "zstream.hh"
+
+namespace sura {
+
+/// the size of decompressed blocks handed to the parser
+const size_t zstream::BLOCK_SIZE = 1024 * 1024;
+
+/**
+ * @brief detect the compression format from the magic number
+ * @param first
+ * @param last
+ * @return format
+ */
+zstream::format zstream::detect(const char* first, const char* last) {
+    const size_t size = last - first;
+    if (size >= 2 && std::memcmp(first, "\x1f\x8b", 2) == 0)
+        return GZIP;
+    if (size >= 6 && std::memcmp(first, "\xfd" "7zXZ\0", 6) == 0)
+        return XZ;
+    if (size >= 4 && std::memcmp(first, "\x28\xb5\x2f\xfd", 4) == 0)
+        return ZSTD;
+    return PLAIN;
+}
+
+/**
+ * @brief the name of a compression format
+ * @param f
+ * @return string
+ */
+string zstream::name(const format& f) {
+    switch (f) {
+    case GZIP:
+        return "gzip";
+    case XZ:
+        return "xz";
+    case ZSTD:
+        return "zstd";
+    default:
+        return "plain";
+    }
+}
+
+/**
+ * @brief decompress a compressed buffer and hand the result to the consumer
+ *        in blocks of at most BLOCK_SIZE bytes. It returns early if the
+ *        consumer closes the queue; it does not close the queue itself.
+ * @param f     : the compression format
+ * @param first : the beginning of compressed buffer
+ * @param last  : the end of compressed buffer
+ * @param blocks: the queue to the consumer
+ */
+void zstream::decompress(const format& f, const char* first, const char* last,
+        blocking_queue<string>& blocks) {
+    switch (f) {
+    case GZIP:
+        decompress_gzip(first, last, blocks);
+        break;
+    case XZ:
+        decompress_xz(first, last, blocks);
+        break;
+    case ZSTD:
+        decompress_zstd(first, last, blocks);
+        break;
+    default:
+        throw ural_rt_err("zstream: the input is not compressed");
+    }
+}
+
+/**
+ * @brief hand a full block to the consumer and start a new one
+ * @param blocks
+ * @param block
+ */
+void zstream::push(blocking_queue<string>& blocks, string& block) {
+    if (!blocks.push(std::move(block)))
+        throw ural_rt_err("zstream: the consumer stopped");
+    block = string();
+}
+
+#ifdef __WITH_ZLIB__
+void zstream::decompress_gzip(const char* first, const char* last,
+        blocking_queue<string>& blocks) {
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, 15 + 32) != Z_OK) /// accept gzip and zlib headers
+        throw ural_rt_err("zstream: cannot initialize zlib");
+
+    const Bytef* in = reinterpret_cast<const Bytef*>(first);
+    size_t n_in = last - first;
+    string block(BLOCK_SIZE, '\0');
+    zs.next_out = reinterpret_cast<Bytef*>(&block[0]);
+    zs.avail_out = BLOCK_SIZE;
+    try {
+        while (true) {
+            if (zs.avail_in == 0 && n_in > 0) { /// avail_in is 32-bit only
+                zs.avail_in = std::min<size_t>(n_in, 1u << 30);
+                zs.next_in = const_cast<Bytef*>(in);
+                in += zs.avail_in;
+                n_in -= zs.avail_in;
+            }
+
+            const int ret = inflate(&zs, Z_NO_FLUSH);
+            bool is_end = false;
+            if (ret == Z_STREAM_END) {
+                if (zs.avail_in == 0 && n_in == 0)
+                    is_end = true;
+                else /// concatenated gzip members
+                    inflateReset(&zs);
+            } else if (ret == Z_BUF_ERROR && zs.avail_in == 0 && n_in == 0) {
+                throw ural_rt_err("zstream: truncated gzip input");
+            } else if (ret != Z_OK) {
+                throw ural_rt_err(
+                        string("zstream: corrupted gzip input: ")
+                                + (zs.msg ? zs.msg : "unexpected end"));
+            }
+
+            if (zs.avail_out == 0 || is_end) {
+                block.resize(BLOCK_SIZE - zs.avail_out);
+                if (!block.empty())
+                    push(blocks, block);
+                if (is_end)
+                    break;
+                block.resize(BLOCK_SIZE);
+                zs.next_out = reinterpret_cast<Bytef*>(&block[0]);
+                zs.avail_out = BLOCK_SIZE;
+            }
+        }
+    } catch (...) {
+        inflateEnd(&zs);
+        throw;
+    }
+    inflateEnd(&zs);
+}
+#else
+void zstream::decompress_gzip(const char* first, const char* last,
+        blocking_queue<string>& blocks) {
+    throw ural_rt_err("zstream: built without gzip support (__WITH_ZLIB__)");
+}
+#endif
+
+#ifdef __WITH_LZMA__
+void zstream::decompress_xz(const char* first, const char* last,
+        blocking_queue<string>& blocks) {
+    lzma_stream strm = LZMA_STREAM_INIT;
+    if (lzma_stream_decoder(&strm, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+        throw ural_rt_err("zstream: cannot initialize lzma");
+
+    strm.next_in = reinterpret_cast<const uint8_t*>(first);
+    strm.avail_in = last - first;
+    string block(BLOCK_SIZE, '\0');
+    strm.next_out = reinterpret_cast<uint8_t*>(&block[0]);
+    strm.avail_out = BLOCK_SIZE;
+    try {
+        while (true) {
+            /// the whole input is mapped already, so always finish
+            const lzma_ret ret = lzma_code(&strm, LZMA_FINISH);
+            if (ret != LZMA_OK && ret != LZMA_STREAM_END)
+                throw ural_rt_err(
+                        "zstream: corrupted xz input (lzma error "
+                                + std::to_string(ret) + ")");
+            if (strm.avail_out == 0 || ret == LZMA_STREAM_END) {
+                block.resize(BLOCK_SIZE - strm.avail_out);
+                if (!block.empty())
+                    push(blocks, block);
+                if (ret == LZMA_STREAM_END)
+                    break;
+                block.resize(BLOCK_SIZE);
+                strm.next_out = reinterpret_cast<uint8_t*>(&block[0]);
+                strm.avail_out = BLOCK_SIZE;
+            }
+        }
+    } catch (...) {
+        lzma_end(&strm);
+        throw;
+    }
+    lzma_end(&strm);
+}
+#else
+void zstream::decompress_xz(const char* first, const char* last,
+        blocking_queue<string>& blocks) {
+    throw ural_rt_err("zstream: built without xz support (__WITH_LZMA__)");
+}
+#endif
+
+#ifdef __WITH_ZSTD__
+void zstream::decompress_zstd(const char* first, const char* last,
+        blocking_queue<string>& blocks) {
+    ZSTD_DStream* ds = ZSTD_createDStream();
+    if (ds == nullptr || ZSTD_isError(ZSTD_initDStream(ds))) {
+        ZSTD_freeDStream(ds);
+        throw ural_rt_err("zstream: cannot initialize zstd");
+    }
+
+    ZSTD_inBuffer in = { first, size_t(last - first), 0 };
+    string block(BLOCK_SIZE, '\0');
+    ZSTD_outBuffer out = { &block[0], BLOCK_SIZE, 0 };
+    size_t ret = 0;
+    try {
+        while (true) {
+            ret = ZSTD_decompressStream(ds, &out, &in);
+            if (ZSTD_isError(ret))
+                throw ural_rt_err(
+                        string("zstream: corrupted zstd input: ")
+                                + ZSTD_getErrorName(ret));
+            if (out.pos == out.size) { /// there may be more buffered output
+                push(blocks, block);
+                block.resize(BLOCK_SIZE);
+                out.dst = &block[0];
+                out.pos = 0;
+            } else if (in.pos == in.size) {
+                break;
+            }
+        }
+        if (ret != 0) /// the last frame is incomplete
+            throw ural_rt_err("zstream: truncated zstd input");
+        block.resize(out.pos);
+        if (!block.empty())
+            push(blocks, block);
+    } catch (...) {
+        ZSTD_freeDStream(ds);
+        throw;
+    }
+    ZSTD_freeDStream(ds);
+}
+#else
+void zstream::decompress_zstd(const char* first, const char* last,
+        blocking_queue<string>& blocks) {
+    throw ural_rt_err("zstream: built without zstd support (__WITH_ZSTD__)");
+}
+#endif
+
+} /* namespace sura */
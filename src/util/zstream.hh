@@ -0,0 +1,44 @@
+/**
+ * @name zstream.hh
+ *
+ * @brief streaming decompression of compressed .ttd inputs. The supported
+ *        codecs are chosen at build time: __WITH_ZLIB__ (gzip),
+ *        __WITH_LZMA__ (xz) and __WITH_ZSTD__ (zstd).
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#ifndef ZSTREAM_HH_
+#define ZSTREAM_HH_
+
+#include "concurrency.hh"
+
+namespace sura {
+
+class zstream {
+public:
+    enum format {
+        PLAIN, GZIP, XZ, ZSTD
+    };
+
+    static const size_t BLOCK_SIZE;
+
+    static format detect(const char* first, const char* last);
+    static string name(const format& f);
+    static void decompress(const format& f, const char* first,
+            const char* last, blocking_queue<string>& blocks);
+
+private:
+    static void decompress_gzip(const char* first, const char* last,
+            blocking_queue<string>& blocks);
+    static void decompress_xz(const char* first, const char* last,
+            blocking_queue<string>& blocks);
+    static void decompress_zstd(const char* first, const char* last,
+            blocking_queue<string>& blocks);
+    static void push(blocking_queue<string>& blocks, string& block);
+};
+
+} /* namespace sura */
+
+#endif /* ZSTREAM_HH_ */
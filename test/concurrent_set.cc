@@ -0,0 +1,136 @@
+/**
+ * @name concurrent_set.cc
+ *
+ * @brief the stress test and throughput benchmark of concurrent_set. Build
+ *        and run it from the top directory by
+ *
+ *        make test [TESTARGS="[max threads] [states per round]"]
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "../src/util/concurrent_set.hh"
+
+using namespace sura;
+
+/// the i-th state of a round, of two words so that both are compared
+static void make_state(const uint64_t& i, uint64_t* w) {
+    w[0] = i * 0x9e3779b97f4a7c15ull;
+    w[1] = ~i;
+}
+
+/// the greatest common divisor
+static uint64_t gcd(const uint64_t& a, const uint64_t& b) {
+    return b == 0 ? a : gcd(b, a % b);
+}
+
+/**
+ * @brief all threads insert the same n states in different orders, twice:
+ *        every state must be new exactly once, and get the same id and
+ *        payload every time
+ * @param n_threads
+ * @param n
+ * @return bool
+ */
+static bool stress(const size_t& n_threads, const uint64_t& n) {
+    concurrent_set R(2, 1);
+    vector<vector<uint64_t>> ids(n_threads, vector<uint64_t>(n));
+    vector<size_t> n_new(n_threads, 0);
+    vector<std::thread> pool;
+    for (size_t t = 0; t < n_threads; ++t) {
+        pool.emplace_back([&, t]() {
+            concurrent_set::handle h(R);
+            /// thread t visits the states with a stride coprime to n
+            uint64_t stride = 2 * t + 1;
+            while (gcd(stride, n) != 1)
+                ++stride;
+            uint64_t w[2];
+            for (size_t round = 0; round < 2; ++round) {
+                for (uint64_t j = 0; j < n; ++j) {
+                    const uint64_t i = (j * stride + t) % n;
+                    make_state(i, w);
+                    const auto& ins = h.insert(w, &i);
+                    if (ins.second)
+                        ++n_new[t];
+                    if (round == 0)
+                        ids[t][i] = ins.first;
+                    else if (ids[t][i] != ins.first)
+                        ids[t][i] = ~uint64_t(0); /// reported below
+                }
+            }
+        });
+    }
+    for (auto it = pool.begin(); it != pool.end(); ++it)
+        it->join();
+
+    size_t total = 0;
+    for (size_t t = 0; t < n_threads; ++t)
+        total += n_new[t];
+    if (total != n || R.size() != n) {
+        cout << "  " << total << " new states, " << R.size()
+                << " in the set, expected " << n << endl;
+        return false;
+    }
+    uint64_t w[2];
+    for (uint64_t i = 0; i < n; ++i) {
+        make_state(i, w);
+        const uint64_t j = ids[0][i];
+        for (size_t t = 1; t < n_threads; ++t)
+            if (ids[t][i] != j) {
+                cout << "  state " << i << " has several ids" << endl;
+                return false;
+            }
+        if (R[j][0] != w[0] || R[j][1] != w[1] || R.payload(j)[0] != i) {
+            cout << "  state " << i << " is stored wrongly" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief insert n states, half of them twice, split over the threads
+ * @param n_threads
+ * @param n
+ * @return double: million inserts per second
+ */
+static double throughput(const size_t& n_threads, const uint64_t& n) {
+    concurrent_set R(2);
+    const auto start = std::chrono::steady_clock::now();
+    vector<std::thread> pool;
+    for (size_t t = 0; t < n_threads; ++t) {
+        pool.emplace_back([&, t]() {
+            concurrent_set::handle h(R);
+            uint64_t w[2];
+            for (uint64_t i = t; i < n + n / 2; i += n_threads) {
+                make_state(i < n ? i : i - n, w);
+                h.insert(w);
+            }
+        });
+    }
+    for (auto it = pool.begin(); it != pool.end(); ++it)
+        it->join();
+    const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    return (n + n / 2) / seconds / 1e6;
+}
+
+int main(const int argc, const char * const * const argv) {
+    const size_t max_threads =
+            argc > 1 ? std::stoul(argv[1]) :
+                    std::max(std::thread::hardware_concurrency(), 1u);
+    const uint64_t n = argc > 2 ? std::stoull(argv[2]) : 1u << 20;
+
+    bool is_passed = true;
+    for (size_t t = 1; t <= max_threads; t *= 2) {
+        const bool ok = stress(t, n);
+        cout << "stress with " << PPRINT::plural(t, "thread") << ": "
+                << (ok ? "passed" : "FAILED") << endl;
+        is_passed = is_passed && ok;
+    }
+    for (size_t t = 1; t <= max_threads; t *= 2)
+        cout << "throughput with " << PPRINT::plural(t, "thread") << ": "
+                << throughput(t, n) << " M inserts/s" << endl;
+    return is_passed ? 0 : 1;
+}
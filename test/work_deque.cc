@@ -0,0 +1,83 @@
+/**
+ * @name work_deque.cc
+ *
+ * @brief the stress test of work_deque. Build and run it from the top
+ *        directory by
+ *
+ *        make test
+ *
+ * @date  : Oct 17, 2026
+ * @author: Peizun Liu
+ */
+
+#include "../src/util/algs.hh"
+#include "../src/util/concurrency.hh"
+
+using namespace sura;
+
+/**
+ * @brief the owner pushes the ids 0 ... n - 1 and pops every third one
+ *        right away, and the remaining ones at the end, while the other
+ *        threads steal: every id must be taken exactly once
+ * @param n_threads: the owner and the thieves
+ * @param n
+ * @return bool
+ */
+static bool stress(const size_t& n_threads, const uint64_t& n) {
+    work_deque D;
+    vector<vector<uint64_t>> taken(n_threads);
+    std::atomic<bool> is_done(false);
+    vector<std::thread> pool;
+    for (size_t t = 1; t < n_threads; ++t) {
+        pool.emplace_back([&, t]() {
+            uint64_t x;
+            while (!is_done.load())
+                if (D.steal(x))
+                    taken[t].push_back(x);
+        });
+    }
+    uint64_t x;
+    for (uint64_t i = 0; i < n; ++i) {
+        D.push(i);
+        if (i % 3 == 0 && D.pop(x))
+            taken[0].push_back(x);
+    }
+    while (D.pop(x))
+        taken[0].push_back(x);
+    is_done = true;
+    for (auto it = pool.begin(); it != pool.end(); ++it)
+        it->join();
+
+    vector<size_t> times(n, 0);
+    for (size_t t = 0; t < n_threads; ++t)
+        for (auto ix = taken[t].begin(); ix != taken[t].end(); ++ix) {
+            if (*ix >= n) {
+                cout << "  id " << *ix << " was never pushed" << endl;
+                return false;
+            }
+            ++times[*ix];
+        }
+    for (uint64_t i = 0; i < n; ++i)
+        if (times[i] != 1) {
+            cout << "  id " << i << " is taken " << times[i] << " times"
+                    << endl;
+            return false;
+        }
+    return true;
+}
+
+int main(const int argc, const char * const * const argv) {
+    const size_t max_threads =
+            argc > 1 ? std::stoul(argv[1]) :
+                    std::max(std::thread::hardware_concurrency(), 1u);
+    const uint64_t n = argc > 2 ? std::stoull(argv[2]) : 1u << 20;
+
+    bool is_passed = true;
+    for (size_t t = 1; t <= std::max(max_threads, size_t(2)); t *= 2) {
+        const bool ok = stress(t, n);
+        cout << "work_deque with " << PPRINT::plural(t, "thread") << ": "
+                << (ok ? "passed" : "FAILED") << endl;
+        is_passed = is_passed && ok;
+    }
+    return is_passed ? 0 : 1;
+}